@@ -1,4 +1,6 @@
 #include "AssetManager.h"
+#include "GLCommandQueue.h"
+#include "JobSystem.h"
 
 #include <stb/stb_image.h>
 #include <assimp/Importer.hpp>
@@ -6,6 +8,7 @@
 #include <assimp/postprocess.h>
 #include <assimp/material.h>
 #include <assimp/texture.h>
+#include <chrono>
 #include <filesystem>
 #include <iostream>
 #include <limits>
@@ -139,6 +142,51 @@ std::shared_ptr<TextureAsset> AssetManager::LoadTexture(const std::string& path,
     return asset;
 }
 
+std::future<std::shared_ptr<TextureAsset>> AssetManager::LoadTextureAsync(const std::string& path, bool srgb)
+{
+    auto promise = std::make_shared<std::promise<std::shared_ptr<TextureAsset>>>();
+    auto result = promise->get_future();
+    if (!GetGLCommandQueue().isBound()) {
+        std::cerr << "[AssetManager] No GL thread to upload texture: " << path << "\n";
+        promise->set_value(nullptr);
+        return result;
+    }
+
+    jobs::Run([path, srgb, promise]() {
+        int w = 0, h = 0, n = 0;
+        // Per-thread flag, so the main thread's loads keep their own setting.
+        stbi_set_flip_vertically_on_load_thread(true);
+
+        std::shared_ptr<unsigned char> data(stbi_load(path.c_str(), &w, &h, &n, 0), stbi_image_free);
+        if (!data) {
+            std::cerr << "[AssetManager] Failed to load texture: " << path << "\n";
+            promise->set_value(nullptr);
+            return;
+        }
+
+        auto upload = GetGLCommandQueue().submit([data, w, h, n, srgb, promise]() {
+            try {
+                promise->set_value(uploadTexture2D(data.get(), w, h, n, srgb));
+            }
+            catch (...) {
+                promise->set_exception(std::current_exception());
+            }
+        });
+
+        // The task itself never throws, so an exception here means the queue
+        // was unbound in the meantime and the task was dropped.
+        if (upload.wait_for(std::chrono::seconds(0)) != std::future_status::ready) return;
+        try {
+            upload.get();
+        }
+        catch (const std::exception& e) {
+            std::cerr << "[AssetManager] Failed to queue texture upload: " << path << " (" << e.what() << ")\n";
+            promise->set_value(nullptr);
+        }
+    });
+    return result;
+}
+
 std::shared_ptr<ShaderAsset> AssetManager::LoadShader(const std::string& vs, const std::string& fs)
 {
     std::string key = vs + "+" + fs;
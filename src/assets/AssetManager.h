@@ -4,6 +4,7 @@
 #include <memory>
 #include <unordered_map>
 #include <cstdint>
+#include <future>
 #include <vector>
 
 #include <glad/glad.h>
@@ -71,6 +72,11 @@ public:
     ~AssetManager();
 
     std::shared_ptr<TextureAsset> LoadTexture(const std::string& path, bool srgb = true);
+    // Decodes on a worker and uploads through the GL command queue, so it
+    // resolves during a later frame's drain. Not cached; resolves to null if
+    // the file can't be decoded or no GL thread is bound to the queue. An
+    // exception thrown by the upload itself is forwarded to the future.
+    std::future<std::shared_ptr<TextureAsset>> LoadTextureAsync(const std::string& path, bool srgb = true);
     std::shared_ptr<ShaderAsset>  LoadShader(const std::string& vertexPath, const std::string& fragmentPath);
     std::shared_ptr<MeshAsset>    LoadMesh(const std::string& modelPath, float desiredSize = 1.0f);
 
@@ -0,0 +1,406 @@
+#include "JobSystem.h"
+#include "ThreadUtil.h"
+#include "Trace.h"
+
+#include <cassert>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace {
+
+    struct Job {
+        std::function<void()> fn;
+        jobs::Counter* counter = nullptr;
+    };
+
+    // Chase-Lev work-stealing deque (Le et al., "Correct and Efficient
+    // Work-Stealing for Weak Memory Models"). Only the owning worker calls
+    // Push/Pop, at the bottom; any thread may Steal from the top. Outgrown
+    // arrays are kept until the deque dies at Shutdown(), since a thief may
+    // still be reading from one.
+    class WorkDeque {
+    public:
+        WorkDeque() {
+            mArrays.push_back(std::make_unique<Array>(INITIAL_CAPACITY));
+            mArray.store(mArrays.back().get(), std::memory_order_relaxed);
+        }
+
+        void Push(Job* job) {
+            const std::int64_t b = mBottom.load(std::memory_order_relaxed);
+            const std::int64_t t = mTop.load(std::memory_order_acquire);
+            Array* a = mArray.load(std::memory_order_relaxed);
+            if (b - t > a->Capacity() - 1) a = Grow(a, t, b);
+            a->Put(b, job);
+            // Release on the store itself (rather than a fence before it) so
+            // a thief's acquire of mBottom also covers the job's contents,
+            // which recycled jobs rewrite just before Push.
+            mBottom.store(b + 1, std::memory_order_release);
+        }
+
+        Job* Pop() {
+            const std::int64_t b = mBottom.load(std::memory_order_relaxed) - 1;
+            Array* a = mArray.load(std::memory_order_relaxed);
+            mBottom.store(b, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            std::int64_t t = mTop.load(std::memory_order_relaxed);
+
+            if (t > b) {
+                mBottom.store(b + 1, std::memory_order_relaxed);
+                return nullptr;
+            }
+            Job* job = a->Get(b);
+            if (t == b) {
+                // Last job: race the thieves for it.
+                if (!mTop.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                    job = nullptr;
+                }
+                mBottom.store(b + 1, std::memory_order_relaxed);
+            }
+            return job;
+        }
+
+        Job* Steal() {
+            std::int64_t t = mTop.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const std::int64_t b = mBottom.load(std::memory_order_acquire);
+            if (t >= b) return nullptr;
+
+            Array* a = mArray.load(std::memory_order_acquire);
+            Job* job = a->Get(t);
+            if (!mTop.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                return nullptr;
+            }
+            return job;
+        }
+
+    private:
+        static constexpr std::int64_t INITIAL_CAPACITY = 256;
+
+        class Array {
+        public:
+            explicit Array(std::int64_t capacity)
+                : mMask(capacity - 1), mSlots(std::make_unique<std::atomic<Job*>[]>(std::size_t(capacity)))
+            {
+            }
+
+            std::int64_t Capacity() const { return mMask + 1; }
+            Job* Get(std::int64_t i) const { return mSlots[std::size_t(i & mMask)].load(std::memory_order_relaxed); }
+            void Put(std::int64_t i, Job* job) { mSlots[std::size_t(i & mMask)].store(job, std::memory_order_relaxed); }
+
+        private:
+            std::int64_t                         mMask;
+            std::unique_ptr<std::atomic<Job*>[]> mSlots;
+        };
+
+        Array* Grow(Array* old, std::int64_t t, std::int64_t b) {
+            mArrays.push_back(std::make_unique<Array>(old->Capacity() * 2));
+            Array* grown = mArrays.back().get();
+            for (std::int64_t i = t; i < b; ++i) grown->Put(i, old->Get(i));
+            mArray.store(grown, std::memory_order_release);
+            return grown;
+        }
+
+        alignas(64) std::atomic<std::int64_t> mTop{ 0 };
+        alignas(64) std::atomic<std::int64_t> mBottom{ 0 };
+        std::atomic<Array*>                   mArray{ nullptr };
+        std::vector<std::unique_ptr<Array>>   mArrays;    // owner only
+    };
+
+    // Jobs queued by threads outside the pool.
+    struct InjectionQueue {
+        std::mutex mtx;
+        std::deque<Job*> jobs;
+    };
+
+    // Jobs held back by RunAfter until their dependency is done.
+    struct Deferred {
+        jobs::Counter* dependency;
+        Job* job;
+    };
+
+    struct Pool {
+        // deques[i - 1] belongs to worker i.
+        std::vector<std::unique_ptr<WorkDeque>> deques;
+        InjectionQueue injection;
+        std::vector<std::thread> workers;
+
+        std::mutex sleepMtx;
+        std::condition_variable cv;
+        std::atomic<uint32_t> queued{ 0 };
+        bool stopping = false;
+
+        std::mutex deferredMtx;
+        std::vector<Deferred> deferred;
+        std::atomic<uint32_t> deferredCount{ 0 };
+
+        // Spare jobs traded between the per-thread caches in batches.
+        std::mutex spareMtx;
+        std::vector<Job*> spareJobs;
+    };
+
+    Pool g_pool;
+    thread_local unsigned t_threadIndex = 0;
+
+    // Finished jobs are reused instead of freed. A job usually finishes on
+    // another thread than the one that queued it (outside threads only
+    // produce, thieves only consume), so each thread keeps a small cache
+    // and trades whole batches with the pool's spare list under its lock.
+    constexpr std::size_t JOB_CACHE_BATCH = 64;
+
+    struct JobCache {
+        std::vector<Job*> jobs;
+
+        ~JobCache() {
+            for (Job* job : jobs) delete job;
+        }
+    };
+
+    thread_local JobCache t_jobCache;
+
+    Job* NewJob(std::function<void()> fn, jobs::Counter* counter) {
+        std::vector<Job*>& cache = t_jobCache.jobs;
+        if (cache.empty()) {
+            std::lock_guard<std::mutex> lk(g_pool.spareMtx);
+            const std::size_t n = std::min(JOB_CACHE_BATCH, g_pool.spareJobs.size());
+            cache.insert(cache.end(), g_pool.spareJobs.end() - n, g_pool.spareJobs.end());
+            g_pool.spareJobs.resize(g_pool.spareJobs.size() - n);
+        }
+        if (cache.empty()) return new Job{ std::move(fn), counter };
+
+        Job* job = cache.back();
+        cache.pop_back();
+        job->fn = std::move(fn);
+        job->counter = counter;
+        return job;
+    }
+
+    void RecycleJob(Job* job) {
+        job->fn = nullptr;    // drops the captures now, not on reuse
+        std::vector<Job*>& cache = t_jobCache.jobs;
+        cache.push_back(job);
+        if (cache.size() < 2 * JOB_CACHE_BATCH) return;
+
+        std::lock_guard<std::mutex> lk(g_pool.spareMtx);
+        g_pool.spareJobs.insert(g_pool.spareJobs.end(), cache.end() - JOB_CACHE_BATCH, cache.end());
+        cache.resize(cache.size() - JOB_CACHE_BATCH);
+    }
+
+    void Enqueue(Job* job);
+
+    // Queues every held-back job whose dependency is done.
+    void ReleaseDeferred() {
+        std::vector<Job*> ready;
+        {
+            std::lock_guard<std::mutex> lk(g_pool.deferredMtx);
+            auto& deferred = g_pool.deferred;
+            for (std::size_t i = 0; i < deferred.size();) {
+                if (deferred[i].dependency->pending.load(std::memory_order_seq_cst) == 0) {
+                    ready.push_back(deferred[i].job);
+                    deferred[i] = deferred.back();
+                    deferred.pop_back();
+                }
+                else {
+                    ++i;
+                }
+            }
+            g_pool.deferredCount.store(static_cast<uint32_t>(deferred.size()), std::memory_order_seq_cst);
+        }
+        for (Job* job : ready) Enqueue(job);
+    }
+
+    void Execute(Job* job) {
+        job->fn();
+        jobs::Counter* counter = job->counter;
+        RecycleJob(job);
+        // counter may be destroyed by its waiter as soon as it reads zero,
+        // so it is not touched after the decrement.
+        if (counter && counter->pending.fetch_sub(1, std::memory_order_seq_cst) == 1
+            && g_pool.deferredCount.load(std::memory_order_seq_cst) != 0) {
+            ReleaseDeferred();
+        }
+    }
+
+    void Enqueue(Job* job) {
+        if (g_pool.workers.empty()) {
+            Execute(job);
+            return;
+        }
+        if (t_threadIndex != 0) {
+            g_pool.deques[t_threadIndex - 1]->Push(job);
+        }
+        else {
+            std::lock_guard<std::mutex> lk(g_pool.injection.mtx);
+            g_pool.injection.jobs.push_back(job);
+        }
+        {
+            // Publish under the sleep lock so a worker can't miss the wakeup.
+            std::lock_guard<std::mutex> lk(g_pool.sleepMtx);
+            g_pool.queued.fetch_add(1, std::memory_order_release);
+        }
+        g_pool.cv.notify_one();
+    }
+
+    Job* PopInjected() {
+        std::lock_guard<std::mutex> lk(g_pool.injection.mtx);
+        if (g_pool.injection.jobs.empty()) return nullptr;
+        Job* job = g_pool.injection.jobs.front();
+        g_pool.injection.jobs.pop_front();
+        return job;
+    }
+
+    Job* TryGet(unsigned self) {
+        if (g_pool.queued.load(std::memory_order_acquire) == 0) return nullptr;
+
+        // Own jobs first (newest, hottest in cache), then outside work, then
+        // the other workers' oldest jobs.
+        Job* job = self != 0 ? g_pool.deques[self - 1]->Pop() : nullptr;
+        if (!job) job = PopInjected();
+        const unsigned n = static_cast<unsigned>(g_pool.deques.size());
+        for (unsigned k = 0; !job && k < n; ++k) {
+            const unsigned victim = (self + k) % n;
+            if (victim + 1 != self) job = g_pool.deques[victim]->Steal();
+        }
+        if (job) g_pool.queued.fetch_sub(1, std::memory_order_acq_rel);
+        return job;
+    }
+
+    void WorkerMain(unsigned index, bool pin) {
+        t_threadIndex = index;
+        const std::string name = "Worker " + std::to_string(index);
+        diag::SetThreadName(name.c_str());
+        if (pin) plat::PinCurrentThread(index);
+
+        for (;;) {
+            if (Job* job = TryGet(index)) {
+                Execute(job);
+                continue;
+            }
+            std::unique_lock<std::mutex> lk(g_pool.sleepMtx);
+            g_pool.cv.wait(lk, [] {
+                return g_pool.stopping || g_pool.queued.load(std::memory_order_acquire) != 0;
+            });
+            if (g_pool.stopping && g_pool.queued.load(std::memory_order_acquire) == 0) return;
+        }
+    }
+
+}
+
+namespace jobs {
+
+    void Initialize(const Options& options) {
+        if (!g_pool.workers.empty()) return;
+        unsigned workerCount = options.workerCount;
+        if (workerCount == 0) {
+            const unsigned hw = std::thread::hardware_concurrency();
+            workerCount = hw > 1 ? hw - 1 : 0;
+        }
+
+        g_pool.stopping = false;
+        g_pool.deques.clear();
+        for (unsigned i = 0; i < workerCount; ++i) {
+            g_pool.deques.push_back(std::make_unique<WorkDeque>());
+        }
+        g_pool.workers.reserve(workerCount);
+        for (unsigned i = 1; i <= workerCount; ++i) {
+            g_pool.workers.emplace_back(WorkerMain, i, options.pinWorkers);
+        }
+    }
+
+    void Initialize(unsigned workerCount) {
+        Options options;
+        options.workerCount = workerCount;
+        Initialize(options);
+    }
+
+    void Shutdown() {
+        {
+            std::lock_guard<std::mutex> lk(g_pool.sleepMtx);
+            g_pool.stopping = true;
+        }
+        g_pool.cv.notify_all();
+        for (auto& t : g_pool.workers) t.join();
+        g_pool.workers.clear();
+
+        // Nothing steals anymore, so the deques can be popped from here.
+        // Whatever these jobs queue runs inline now that workers is empty.
+        for (;;) {
+            Job* job = PopInjected();
+            for (std::size_t i = 0; !job && i < g_pool.deques.size(); ++i) job = g_pool.deques[i]->Pop();
+            if (!job) break;
+            Execute(job);
+        }
+        g_pool.queued.store(0, std::memory_order_relaxed);
+
+        {
+            std::lock_guard<std::mutex> lk(g_pool.deferredMtx);
+            assert(g_pool.deferred.empty() && "Shutdown with RunAfter jobs whose dependency never finished.");
+            for (const Deferred& d : g_pool.deferred) delete d.job;
+            g_pool.deferred.clear();
+            g_pool.deferredCount.store(0, std::memory_order_relaxed);
+        }
+
+        // Frees every array the deques grew into along the way.
+        g_pool.deques.clear();
+
+        std::lock_guard<std::mutex> lk(g_pool.spareMtx);
+        for (Job* job : g_pool.spareJobs) delete job;
+        g_pool.spareJobs.clear();
+    }
+
+    unsigned WorkerCount() {
+        return static_cast<unsigned>(g_pool.workers.size());
+    }
+
+    unsigned ThreadIndex() {
+        return t_threadIndex;
+    }
+
+    void Run(std::function<void()> job, Counter* counter) {
+        if (counter) counter->pending.fetch_add(1, std::memory_order_relaxed);
+        Enqueue(NewJob(std::move(job), counter));
+    }
+
+    void RunAfter(Counter& dependency, std::function<void()> job, Counter* counter) {
+        if (counter) counter->pending.fetch_add(1, std::memory_order_relaxed);
+        Job* j = NewJob(std::move(job), counter);
+        {
+            // Held back under the lock, then rechecked: either the last job
+            // of dependency sees this entry when it finishes, or the recheck
+            // sees the dependency done.
+            std::lock_guard<std::mutex> lk(g_pool.deferredMtx);
+            if (dependency.pending.load(std::memory_order_seq_cst) != 0) {
+                g_pool.deferred.push_back(Deferred{ &dependency, j });
+                g_pool.deferredCount.fetch_add(1, std::memory_order_seq_cst);
+                if (dependency.pending.load(std::memory_order_seq_cst) != 0) return;
+                g_pool.deferred.pop_back();
+                g_pool.deferredCount.fetch_sub(1, std::memory_order_seq_cst);
+            }
+        }
+        Enqueue(j);
+    }
+
+    void WaitFor(Counter& counter) {
+        // Help instead of blocking; the jobs we pick up may belong to other
+        // counters, which is fine.
+        while (!counter.done()) {
+            Job* job = g_pool.workers.empty() ? nullptr : TryGet(t_threadIndex);
+            if (job) {
+                Execute(job);
+            }
+            else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    std::size_t AutoGrain(std::size_t count, std::size_t bytesPerItem) {
+        const std::size_t threads = std::size_t(WorkerCount()) + 1;
+        const std::size_t balanced = (count + threads * 4 - 1) / (threads * 4);
+        return std::max(kMinGrain, std::min(FixedGrain(bytesPerItem), balanced));
+    }
+
+}
@@ -0,0 +1,126 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include <vector>
+
+// Fixed pool of worker threads with one lock-free Chase-Lev deque per
+// worker. A worker pushes and pops its own jobs LIFO and steals from the
+// others FIFO when it runs dry; threads outside the pool share a locked
+// injection queue. Work is grouped with a Counter: Run() bumps it, job
+// completion drops it, and WaitFor() executes queued jobs on the calling
+// thread until it reaches zero. RunAfter() holds a job back until another
+// counter is done, which is enough to express a dependency graph.
+// Finished jobs are recycled, so a job whose callable fits std::function's
+// inline storage (a couple of pointers) queues without allocating.
+//
+// Workers are named "Worker N" for debuggers and in exported Chrome
+// traces, so ZONE_CPU scopes inside jobs show up under their thread.
+//
+// With no workers (single-core machines, or before Initialize()) Run()
+// executes the job inline, so callers never need a serial fallback.
+// Shutdown() runs anything still queued on the calling thread before it
+// frees the deques, so no job is dropped between Initialize() cycles.
+
+namespace jobs {
+
+    struct Counter {
+        std::atomic<uint32_t> pending{ 0 };
+
+        bool done() const { return pending.load(std::memory_order_acquire) == 0; }
+    };
+
+    struct Options {
+        unsigned workerCount = 0;     // 0 picks hardware_concurrency() - 1
+        bool     pinWorkers = false;  // worker N on logical CPU N; the caller keeps CPU 0
+    };
+
+    void Initialize(const Options& options);
+    void Initialize(unsigned workerCount = 0);
+    void Shutdown();
+    unsigned WorkerCount();
+
+    // 0 for threads outside the pool, 1..WorkerCount() for workers.
+    unsigned ThreadIndex();
+
+    void Run(std::function<void()> job, Counter* counter = nullptr);
+    // Queues job once dependency is done; counter is bumped right away, so
+    // waiting on it covers the held-back job too. dependency must outlive
+    // the job's start, which waiting on counter before destroying it does.
+    void RunAfter(Counter& dependency, std::function<void()> job, Counter* counter = nullptr);
+    void WaitFor(Counter& counter);
+
+    // Target bytes touched per batch; small enough to stay in L1/L2 while
+    // a batch runs, large enough to amortize scheduling.
+    inline constexpr std::size_t kBatchBytes = 16 * 1024;
+    inline constexpr std::size_t kMinGrain = 64;
+
+    // Batch size for count items of bytesPerItem each: capped by the cache
+    // budget, and small enough to give every thread a few batches to steal.
+    std::size_t AutoGrain(std::size_t count, std::size_t bytesPerItem);
+
+    // Batch size that depends only on the item size, for reductions that
+    // must split the same way regardless of the worker count.
+    inline std::size_t FixedGrain(std::size_t bytesPerItem) {
+        return std::max(kMinGrain, kBatchBytes / std::max<std::size_t>(1, bytesPerItem));
+    }
+
+    // fn(begin, end) over [0, count) in batches of grain, possibly on
+    // several threads at once. Returns when every batch has finished.
+    template<typename Fn>
+    void ParallelFor(std::size_t count, std::size_t grain, Fn&& fn) {
+        if (count == 0) return;
+        grain = std::max<std::size_t>(grain, 1);
+        if (WorkerCount() == 0 || count <= grain) {
+            fn(std::size_t(0), count);
+            return;
+        }
+
+        // Each batch captures only this and its start, which keeps the
+        // closure within std::function's inline storage.
+        struct Batches {
+            std::remove_reference_t<Fn>* fn;
+            std::size_t grain;
+            std::size_t count;
+        };
+        const Batches batches{ &fn, grain, count };
+
+        Counter counter;
+        for (std::size_t begin = grain; begin < count; begin += grain) {
+            Run([&batches, begin] {
+                (*batches.fn)(begin, std::min(begin + batches.grain, batches.count));
+            }, &counter);
+        }
+        fn(std::size_t(0), grain);
+        WaitFor(counter);
+    }
+
+    // One T per thread that can run jobs, padded to its own cache line.
+    // Local() is only safe from the pool's workers and from one outside
+    // thread at a time (they share slot 0).
+    template<typename T>
+    class WorkerLocal {
+    public:
+        explicit WorkerLocal(const T& init = T{})
+            : slots_(WorkerCount() + 1, Slot{ init })
+        {
+        }
+
+        T& Local() { return slots_[ThreadIndex()].value; }
+
+        template<typename Fn>
+        void ForEach(Fn&& fn) {
+            for (Slot& s : slots_) fn(s.value);
+        }
+
+    private:
+        struct alignas(64) Slot {
+            T value;
+        };
+        std::vector<Slot> slots_;
+    };
+
+}
@@ -4,13 +4,14 @@
 namespace diag {
 
     MetricsRegistry::MetricsRegistry(int rollingFrames)
-        : frameTimesMs_(rollingFrames) {
+        : rollingFrames_(rollingFrames), frameTimesMs_(rollingFrames) {
     }
 
     void MetricsRegistry::beginFrame(uint64_t frameIdx) {
         frameIdx_ = frameIdx;
         cpuAccum_.clear();
         gpuAccum_.clear();
+        systemAccum_.clear();
     }
 
     void MetricsRegistry::endFrame(uint64_t) {
@@ -42,6 +43,34 @@ namespace diag {
             lastGpuScopes_.end(),
             [](const ScopeSample& a, const ScopeSample& b) { return a.ms > b.ms; }
         );
+
+        // Per-system windows only advance on frames the system ran.
+        lastSystems_.clear();
+        lastSystems_.reserve(systemAccum_.size());
+        for (auto& kv : systemAccum_) {
+            SystemSample s = kv.second;
+            systemTimesMs_.try_emplace(kv.first, rollingFrames_).first->second.push(s.ms);
+            s.over_budget = s.budget_ms > 0.0 && s.ms > s.budget_ms;
+            lastSystems_.push_back(s);
+        }
+        std::sort(
+            lastSystems_.begin(),
+            lastSystems_.end(),
+            [](const SystemSample& a, const SystemSample& b) { return a.ms > b.ms; }
+        );
+    }
+
+    SystemStats MetricsRegistry::systemStats(const SystemSample& s) const {
+        SystemStats stats;
+        auto it = systemTimesMs_.find(s.name ? s.name : "System");
+        if (it == systemTimesMs_.end()) return stats;
+        const auto times = it->second.snapshot();
+        stats.pct = compute_percentiles(times);
+        if (s.budget_ms > 0.0) {
+            stats.overruns = static_cast<int>(std::count_if(times.begin(), times.end(),
+                [&](double ms) { return ms > s.budget_ms; }));
+        }
+        return stats;
     }
 
     void MetricsRegistry::addCpuScope(const char* name, double ms) {
@@ -51,6 +80,16 @@ namespace diag {
         s.calls += 1;
     }
 
+    void MetricsRegistry::addSystemSample(const char* name, double ms, size_t entities, double budgetMs) {
+        addCpuScope(name, ms);
+        auto& s = systemAccum_[name ? name : "System"];
+        s.name = name;
+        s.ms += ms;
+        s.calls += 1;
+        s.entities = entities;
+        s.budget_ms = budgetMs;
+    }
+
     void MetricsRegistry::addGpuScope(const char* name, double ms) {
         auto& s = gpuAccum_[name ? name : "GPU"];
         s.name = name;
@@ -3,6 +3,7 @@
 #include <string>
 #include <vector>
 #include <unordered_map>
+#include <utility>
 
 namespace diag {
 
@@ -12,6 +13,22 @@ namespace diag {
         int calls = 0;
     };
 
+    // One ECS system's time this frame.
+    struct SystemSample {
+        const char* name = nullptr;
+        double ms = 0.0;
+        int calls = 0;
+        size_t entities = 0;
+        double budget_ms = 0.0;   // 0 = no budget
+        bool over_budget = false;
+    };
+
+    // One ECS system's rolling distribution; see MetricsRegistry::systemStats.
+    struct SystemStats {
+        Percentiles pct{};
+        int overruns = 0;         // frames over budget in the rolling window
+    };
+
     struct FrameMetrics {
         double cpu_ms = 0.0;
         double gpu_ms = 0.0;
@@ -19,8 +36,23 @@ namespace diag {
         bool spike = false;
     };
 
+    // One ECS component pool; used is what its live entries need.
+    struct EcsPoolMemory {
+        const char* name = nullptr;
+        uint64_t capacity = 0, live = 0, reserved = 0, used = 0;
+    };
+
     struct EngineMemory {
         uint64_t textures = 0, buffers = 0, meshes = 0, other = 0;
+        // ECS storage: entity table, system membership sets, and every pool.
+        uint64_t ecs_entities = 0, ecs_systems = 0;
+        std::vector<EcsPoolMemory> ecs_pools;
+
+        uint64_t ecsReserved() const {
+            uint64_t bytes = ecs_entities + ecs_systems;
+            for (const auto& p : ecs_pools) bytes += p.reserved;
+            return bytes;
+        }
     };
 
     struct ProcessMemory {
@@ -35,7 +67,10 @@ namespace diag {
         void endFrame(uint64_t frameIdx);
         void addCpuScope(const char* name, double ms);
         void addGpuScope(const char* name, double ms);
+        // Also counted as a CPU scope under the same name.
+        void addSystemSample(const char* name, double ms, size_t entities, double budgetMs);
         void publishProcessMemory(const ProcessMemory& pm) { procMem_ = pm; }
+        // Copy-assigned, so the pool list reuses its storage from frame to frame.
         void publishEngineMemory(const EngineMemory& em) { engMem_ = em; }
         void setCpuFrameMs(double ms) { current_.cpu_ms = ms; }
         void setGpuFrameMs(double ms) { current_.gpu_ms = ms; }
@@ -46,11 +81,16 @@ namespace diag {
         const Percentiles& framePercentiles() const { return lastPct_; }
         const std::vector<ScopeSample>& lastCpuScopes() const { return lastCpuScopes_; }
         const std::vector<ScopeSample>& lastGpuScopes() const { return lastGpuScopes_; }
+        const std::vector<SystemSample>& lastSystems() const { return lastSystems_; }
+        // Walks the system's rolling window on every call, so only ask while
+        // displaying it.
+        SystemStats systemStats(const SystemSample& s) const;
         const EngineMemory& engineMemory() const { return engMem_; }
         const ProcessMemory& processMemory() const { return procMem_; }
 
     private:
         uint64_t frameIdx_ = 0;
+        int rollingFrames_ = 600;
         RollingWindow<double> frameTimesMs_;
         Percentiles lastPct_{};
 
@@ -60,6 +100,10 @@ namespace diag {
         std::vector<ScopeSample> lastCpuScopes_;
         std::vector<ScopeSample> lastGpuScopes_;
 
+        std::unordered_map<std::string, SystemSample> systemAccum_;
+        std::unordered_map<std::string, RollingWindow<double>> systemTimesMs_;
+        std::vector<SystemSample> lastSystems_;
+
         FrameMetrics current_{};
         EngineMemory engMem_{};
         ProcessMemory procMem_{};
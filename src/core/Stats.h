@@ -46,20 +46,24 @@ namespace diag {
         Percentiles p{};
         if (xs.empty()) return p;
         std::vector<double> v = xs;
-        std::sort(v.begin(), v.end());
+        // Quantiles are taken in increasing order with nth_element, each
+        // searching only above the previous one, instead of sorting v.
+        size_t lo = 0;
         auto at = [&](double q)->double {
-            if (v.empty()) return 0;
             double idx = q * (v.size() - 1);
             size_t i = (size_t)idx;
-            size_t j = std::min(i + 1, v.size() - 1);
             double t = idx - i;
-            return v[i] * (1.0 - t) + v[j] * t;
+            std::nth_element(v.begin() + lo, v.begin() + i, v.end());
+            lo = i;
+            if (i + 1 >= v.size()) return v[i];
+            double next = *std::min_element(v.begin() + i + 1, v.end());
+            return v[i] * (1.0 - t) + next * t;
             };
+        p.q1 = at(0.25);
         p.p50 = at(0.50);
+        p.q3 = at(0.75);
         p.p95 = at(0.95);
         p.p99 = at(0.99);
-        p.q1 = at(0.25);
-        p.q3 = at(0.75);
         p.iqr = p.q3 - p.q1;
         return p;
     }
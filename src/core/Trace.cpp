@@ -1,10 +1,36 @@
 #include "Trace.h"
 #include "Chrono.h"
+#include "ThreadUtil.h"
 
+#include <memory>
 #include <unordered_map>
 
 namespace {
-	thread_local std::vector<diag::TraceEvent> t_localEvents;
+	// Each thread appends to its own buffer; endFrame() gathers all of them,
+	// so zones recorded on worker threads show up next to the main thread's.
+	struct ThreadEvents {
+		std::mutex mtx;
+		std::vector<diag::TraceEvent> events;
+	};
+
+	std::mutex g_threadsMtx;
+	std::vector<std::shared_ptr<ThreadEvents>> g_threads;
+	std::vector<diag::ThreadName> g_threadNames;
+
+	std::shared_ptr<ThreadEvents> RegisterThread() {
+		auto buf = std::make_shared<ThreadEvents>();
+		std::lock_guard<std::mutex> lk(g_threadsMtx);
+		g_threads.push_back(buf);
+		return buf;
+	}
+
+	thread_local std::shared_ptr<ThreadEvents> t_localEvents = RegisterThread();
+
+	inline void push_local(const diag::TraceEvent& ev) {
+		std::lock_guard<std::mutex> lk(t_localEvents->mtx);
+		t_localEvents->events.push_back(ev);
+	}
+
 	inline uint32_t thread_id_u32() {
 		auto id = std::hash<std::thread::id>{}(std::this_thread::get_id());
 		return static_cast<uint32_t>(id);
@@ -18,9 +44,18 @@ namespace diag {
 
 	void TraceCollector::endFrame(uint64_t) {
 		std::lock_guard<std::mutex> lk(mtx_);
-		aggregated_.reserve(aggregated_.size() + t_localEvents.size());
-		aggregated_.insert(aggregated_.end(), t_localEvents.begin(), t_localEvents.end());
-		t_localEvents.clear();
+		std::lock_guard<std::mutex> threadsLk(g_threadsMtx);
+		for (auto it = g_threads.begin(); it != g_threads.end();) {
+			ThreadEvents& buf = **it;
+			{
+				std::lock_guard<std::mutex> bufLk(buf.mtx);
+				aggregated_.insert(aggregated_.end(), buf.events.begin(), buf.events.end());
+				buf.events.clear();
+			}
+			// Drop buffers of threads that have exited.
+			if (it->use_count() == 1) it = g_threads.erase(it);
+			else ++it;
+		}
 	}
 
 	void TraceCollector::record(const TraceEvent& ev) {
@@ -30,15 +65,33 @@ namespace diag {
 
 	ScopedCpuZone::ScopedCpuZone(const char* name, const char* file, uint32_t line)
 		: name_(name), file_(file), line_(line), start_ns_(now_ns()), tid_(thread_id_u32()) {
-		t_localEvents.push_back(TraceEvent{ name_, file_, line_, EventType::Begin, start_ns_, tid_ });
+		push_local(TraceEvent{ name_, file_, line_, EventType::Begin, start_ns_, tid_ });
 	}
 
 	ScopedCpuZone::~ScopedCpuZone() {
 		int64_t end_ns = now_ns();
-		t_localEvents.push_back(TraceEvent{ name_, file_, line_, EventType::End, end_ns, tid_ });
+		push_local(TraceEvent{ name_, file_, line_, EventType::End, end_ns, tid_ });
 	}
 
 	void Mark(EventType t, const char* name, const char* file, uint32_t line) {
-		t_localEvents.push_back(TraceEvent{ name, file, line, t, now_ns(), thread_id_u32() });
+		push_local(TraceEvent{ name, file, line, t, now_ns(), thread_id_u32() });
+	}
+
+	void SetThreadName(const char* name) {
+		plat::SetCurrentThreadName(name);
+		const uint32_t tid = thread_id_u32();
+		std::lock_guard<std::mutex> lk(g_threadsMtx);
+		for (ThreadName& known : g_threadNames) {
+			if (known.tid == tid) {
+				known.name = name;
+				return;
+			}
+		}
+		g_threadNames.push_back(ThreadName{ tid, name });
+	}
+
+	std::vector<ThreadName> ThreadNames() {
+		std::lock_guard<std::mutex> lk(g_threadsMtx);
+		return g_threadNames;
 	}
 }
\ No newline at end of file
@@ -43,4 +43,13 @@ namespace diag {
 	};
 
 	void Mark(EventType t, const char* name, const char* file, uint32_t line);
+
+	// Label for the calling thread in exported traces (and debuggers, via
+	// the platform layer). tid matches TraceEvent::tid.
+	struct ThreadName {
+		uint32_t tid;
+		std::string name;
+	};
+	void SetThreadName(const char* name);
+	std::vector<ThreadName> ThreadNames();
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "TraceChrome.h"
 
+#include <cstdio>
 #include <fstream>
 #include <string>
 
@@ -14,20 +15,53 @@ namespace diag {
         return "i";
     }
 
+    // s as a JSON string literal, quotes included.
+    static void writeJsonString(std::ostream& out, const char* s) {
+        out << '"';
+        for (; *s; ++s) {
+            const unsigned char c = static_cast<unsigned char>(*s);
+            if (c == '"' || c == '\\') {
+                out << '\\' << *s;
+            }
+            else if (c < 0x20) {
+                char escaped[8];
+                std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                out << escaped;
+            }
+            else {
+                out << *s;
+            }
+        }
+        out << '"';
+    }
+
     bool WriteChromeTraceJSON(const TraceCollector& tc, const std::string& path) {
         std::ofstream out(path, std::ios::binary);
         if (!out) return false;
         out << "{ \"traceEvents\":[\n";
-        const auto& evs = tc.events();
-        for (size_t i = 0; i < evs.size(); ++i) {
-            const auto& e = evs[i];
-            out << " {\"name\":\"" << (e.name ? e.name : "?")
-                << "\",\"ph\":\"" << phase(e.type)
+        bool first = true;
+        auto separate = [&] {
+            if (!first) out << ",\n";
+            first = false;
+        };
+
+        // Metadata first, so viewers label threads by name instead of id.
+        for (const auto& t : ThreadNames()) {
+            separate();
+            out << " {\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << t.tid
+                << ",\"args\":{\"name\":";
+            writeJsonString(out, t.name.c_str());
+            out << "}}";
+        }
+        for (const auto& e : tc.events()) {
+            separate();
+            out << " {\"name\":";
+            writeJsonString(out, e.name ? e.name : "?");
+            out << ",\"ph\":\"" << phase(e.type)
                 << "\",\"ts\":" << (e.ts_ns / 1000)
                 << ",\"pid\":1"
                 << ",\"tid\":" << e.tid
                 << "}";
-            if (i + 1 < evs.size()) out << ",\n";
         }
         out << "\n] }\n";
         return true;
@@ -0,0 +1,265 @@
+#include "TransformKernel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define XFORM_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#else
+#define XFORM_X86 0
+#endif
+
+// MSVC accepts intrinsics anywhere; GCC/Clang need the ISA on the function.
+#if XFORM_X86 && (defined(__GNUC__) || defined(__clang__))
+#define XFORM_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define XFORM_TARGET_AVX2
+#endif
+
+namespace {
+
+    // Transforms per scalar trig pre-pass on the Euler path.
+    constexpr std::size_t kTrigBlock = 64;
+
+    std::atomic<int> g_isa{ -1 };
+
+    // Same expression order as glm::mat3_cast, then the scale and
+    // translation columns.
+    inline void StoreScalar(float x, float y, float z, float w,
+        float px, float py, float pz, float sx, float sy, float sz, float* m)
+    {
+        const float xx = x * x, yy = y * y, zz = z * z;
+        const float xz = x * z, xy = x * y, yz = y * z;
+        const float wx = w * x, wy = w * y, wz = w * z;
+
+        m[0] = (1.0f - 2.0f * (yy + zz)) * sx;
+        m[1] = (2.0f * (xy + wz)) * sx;
+        m[2] = (2.0f * (xz - wy)) * sx;
+        m[3] = 0.0f;
+        m[4] = (2.0f * (xy - wz)) * sy;
+        m[5] = (1.0f - 2.0f * (xx + zz)) * sy;
+        m[6] = (2.0f * (yz + wx)) * sy;
+        m[7] = 0.0f;
+        m[8] = (2.0f * (xz + wy)) * sz;
+        m[9] = (2.0f * (yz - wx)) * sz;
+        m[10] = (1.0f - 2.0f * (xx + yy)) * sz;
+        m[11] = 0.0f;
+        m[12] = px;
+        m[13] = py;
+        m[14] = pz;
+        m[15] = 1.0f;
+    }
+
+    void QuatScalar(const float* qx, const float* qy, const float* qz, const float* qw,
+        const xform::TrsSoA& in, std::size_t begin, std::size_t end, float* out)
+    {
+        for (std::size_t i = begin; i < end; ++i) {
+            StoreScalar(qx[i], qy[i], qz[i], qw[i],
+                in.px[i], in.py[i], in.pz[i], in.sx[i], in.sy[i], in.sz[i], out + 16 * i);
+        }
+    }
+
+#if XFORM_X86
+
+    // Twelve registers with one transform per lane -> four matrices.
+    inline void TransposeStore4(__m128 c0x, __m128 c0y, __m128 c0z,
+        __m128 c1x, __m128 c1y, __m128 c1z,
+        __m128 c2x, __m128 c2y, __m128 c2z,
+        __m128 c3x, __m128 c3y, __m128 c3z, float* m)
+    {
+        __m128 c0w = _mm_setzero_ps();
+        __m128 c1w = _mm_setzero_ps();
+        __m128 c2w = _mm_setzero_ps();
+        __m128 c3w = _mm_set1_ps(1.0f);
+        _MM_TRANSPOSE4_PS(c0x, c0y, c0z, c0w);
+        _MM_TRANSPOSE4_PS(c1x, c1y, c1z, c1w);
+        _MM_TRANSPOSE4_PS(c2x, c2y, c2z, c2w);
+        _MM_TRANSPOSE4_PS(c3x, c3y, c3z, c3w);
+
+        _mm_storeu_ps(m + 0, c0x);  _mm_storeu_ps(m + 4, c1x);  _mm_storeu_ps(m + 8, c2x);  _mm_storeu_ps(m + 12, c3x);
+        _mm_storeu_ps(m + 16, c0y); _mm_storeu_ps(m + 20, c1y); _mm_storeu_ps(m + 24, c2y); _mm_storeu_ps(m + 28, c3y);
+        _mm_storeu_ps(m + 32, c0z); _mm_storeu_ps(m + 36, c1z); _mm_storeu_ps(m + 40, c2z); _mm_storeu_ps(m + 44, c3z);
+        _mm_storeu_ps(m + 48, c0w); _mm_storeu_ps(m + 52, c1w); _mm_storeu_ps(m + 56, c2w); _mm_storeu_ps(m + 60, c3w);
+    }
+
+    void QuatSSE(const float* qx, const float* qy, const float* qz, const float* qw,
+        const xform::TrsSoA& in, std::size_t begin, std::size_t end, float* out)
+    {
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 two = _mm_set1_ps(2.0f);
+
+        std::size_t i = begin;
+        for (; i + 4 <= end; i += 4) {
+            const __m128 x = _mm_loadu_ps(qx + i), y = _mm_loadu_ps(qy + i);
+            const __m128 z = _mm_loadu_ps(qz + i), w = _mm_loadu_ps(qw + i);
+
+            const __m128 xx = _mm_mul_ps(x, x), yy = _mm_mul_ps(y, y), zz = _mm_mul_ps(z, z);
+            const __m128 xz = _mm_mul_ps(x, z), xy = _mm_mul_ps(x, y), yz = _mm_mul_ps(y, z);
+            const __m128 wx = _mm_mul_ps(w, x), wy = _mm_mul_ps(w, y), wz = _mm_mul_ps(w, z);
+
+            const __m128 sx = _mm_loadu_ps(in.sx + i);
+            const __m128 sy = _mm_loadu_ps(in.sy + i);
+            const __m128 sz = _mm_loadu_ps(in.sz + i);
+
+            TransposeStore4(
+                _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))), sx),
+                _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xy, wz)), sx),
+                _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xz, wy)), sx),
+                _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xy, wz)), sy),
+                _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))), sy),
+                _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(yz, wx)), sy),
+                _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xz, wy)), sz),
+                _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(yz, wx)), sz),
+                _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))), sz),
+                _mm_loadu_ps(in.px + i), _mm_loadu_ps(in.py + i), _mm_loadu_ps(in.pz + i),
+                out + 16 * i);
+        }
+        QuatScalar(qx, qy, qz, qw, in, i, end, out);
+    }
+
+    XFORM_TARGET_AVX2
+    void QuatAVX2(const float* qx, const float* qy, const float* qz, const float* qw,
+        const xform::TrsSoA& in, std::size_t begin, std::size_t end, float* out)
+    {
+        const __m256 one = _mm256_set1_ps(1.0f);
+        const __m256 two = _mm256_set1_ps(2.0f);
+
+        std::size_t i = begin;
+        for (; i + 8 <= end; i += 8) {
+            const __m256 x = _mm256_loadu_ps(qx + i), y = _mm256_loadu_ps(qy + i);
+            const __m256 z = _mm256_loadu_ps(qz + i), w = _mm256_loadu_ps(qw + i);
+
+            const __m256 xx = _mm256_mul_ps(x, x), yy = _mm256_mul_ps(y, y), zz = _mm256_mul_ps(z, z);
+            const __m256 xz = _mm256_mul_ps(x, z), xy = _mm256_mul_ps(x, y), yz = _mm256_mul_ps(y, z);
+            const __m256 wx = _mm256_mul_ps(w, x), wy = _mm256_mul_ps(w, y), wz = _mm256_mul_ps(w, z);
+
+            const __m256 sx = _mm256_loadu_ps(in.sx + i);
+            const __m256 sy = _mm256_loadu_ps(in.sy + i);
+            const __m256 sz = _mm256_loadu_ps(in.sz + i);
+
+            const __m256 c[12] = {
+                _mm256_mul_ps(_mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(yy, zz))), sx),
+                _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(xy, wz)), sx),
+                _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(xz, wy)), sx),
+                _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(xy, wz)), sy),
+                _mm256_mul_ps(_mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(xx, zz))), sy),
+                _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(yz, wx)), sy),
+                _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(xz, wy)), sz),
+                _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(yz, wx)), sz),
+                _mm256_mul_ps(_mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(xx, yy))), sz),
+                _mm256_loadu_ps(in.px + i), _mm256_loadu_ps(in.py + i), _mm256_loadu_ps(in.pz + i),
+            };
+
+            // Transpose each 128-bit half with the SSE path.
+            __m128 lo[12], hi[12];
+            for (int k = 0; k < 12; ++k) {
+                lo[k] = _mm256_castps256_ps128(c[k]);
+                hi[k] = _mm256_extractf128_ps(c[k], 1);
+            }
+            TransposeStore4(lo[0], lo[1], lo[2], lo[3], lo[4], lo[5], lo[6], lo[7], lo[8], lo[9], lo[10], lo[11],
+                out + 16 * i);
+            TransposeStore4(hi[0], hi[1], hi[2], hi[3], hi[4], hi[5], hi[6], hi[7], hi[8], hi[9], hi[10], hi[11],
+                out + 16 * (i + 4));
+        }
+        QuatSSE(qx, qy, qz, qw, in, i, end, out);
+    }
+
+#endif
+
+    void ComposeQuatRange(const float* qx, const float* qy, const float* qz, const float* qw,
+        const xform::TrsSoA& in, std::size_t begin, std::size_t end, float* out)
+    {
+#if XFORM_X86
+        switch (xform::ActiveIsa()) {
+        case xform::Isa::AVX2: QuatAVX2(qx, qy, qz, qw, in, begin, end, out); return;
+        case xform::Isa::SSE:  QuatSSE(qx, qy, qz, qw, in, begin, end, out); return;
+        case xform::Isa::Scalar: break;
+        }
+#endif
+        QuatScalar(qx, qy, qz, qw, in, begin, end, out);
+    }
+
+}
+
+namespace xform {
+
+    Isa DetectIsa() {
+#if XFORM_X86
+#if defined(_MSC_VER)
+        int regs[4];
+        __cpuid(regs, 1);
+        const bool osxsave = (regs[2] & (1 << 27)) != 0;
+        const bool avx = (regs[2] & (1 << 28)) != 0;
+        bool avx2 = false;
+        if (osxsave && avx && (_xgetbv(0) & 0x6) == 0x6) {
+            __cpuidex(regs, 7, 0);
+            avx2 = (regs[1] & (1 << 5)) != 0;
+        }
+        return avx2 ? Isa::AVX2 : Isa::SSE;
+#else
+        return __builtin_cpu_supports("avx2") ? Isa::AVX2 : Isa::SSE;
+#endif
+#else
+        return Isa::Scalar;
+#endif
+    }
+
+    Isa ActiveIsa() {
+        int isa = g_isa.load(std::memory_order_relaxed);
+        if (isa < 0) {
+            isa = static_cast<int>(DetectIsa());
+            g_isa.store(isa, std::memory_order_relaxed);
+        }
+        return static_cast<Isa>(isa);
+    }
+
+    void SetIsa(Isa isa) {
+        const int best = static_cast<int>(DetectIsa());
+        g_isa.store(std::min(static_cast<int>(isa), best), std::memory_order_relaxed);
+    }
+
+    const char* IsaName(Isa isa) {
+        switch (isa) {
+        case Isa::Scalar: return "scalar";
+        case Isa::SSE: return "sse";
+        case Isa::AVX2: return "avx2";
+        }
+        return "?";
+    }
+
+    void ComposeQuat(const TrsSoA& in, std::size_t count, float* out) {
+        ComposeQuatRange(in.qx, in.qy, in.qz, in.qw, in, 0, count, out);
+    }
+
+    void ComposeEuler(const TrsSoA& in, std::size_t count, float* out) {
+        // glm::quat(euler): half-angle trig per axis, then the products.
+        float qx[kTrigBlock], qy[kTrigBlock], qz[kTrigBlock], qw[kTrigBlock];
+
+        for (std::size_t base = 0; base < count; base += kTrigBlock) {
+            const std::size_t n = std::min(kTrigBlock, count - base);
+            for (std::size_t k = 0; k < n; ++k) {
+                const std::size_t i = base + k;
+                const float hx = in.rx[i] * 0.5f, hy = in.ry[i] * 0.5f, hz = in.rz[i] * 0.5f;
+                const float cx = std::cos(hx), cy = std::cos(hy), cz = std::cos(hz);
+                const float sx = std::sin(hx), sy = std::sin(hy), sz = std::sin(hz);
+                qw[k] = cx * cy * cz + sx * sy * sz;
+                qx[k] = sx * cy * cz - cx * sy * sz;
+                qy[k] = cx * sy * cz + sx * cy * sz;
+                qz[k] = cx * cy * sz - sx * sy * cz;
+            }
+
+            // The block's quaternions are indexed from 0; shift the other
+            // inputs and the output to match.
+            TrsSoA block = in;
+            block.px += base; block.py += base; block.pz += base;
+            block.sx += base; block.sy += base; block.sz += base;
+            ComposeQuatRange(qx, qy, qz, qw, block, 0, n, out + 16 * base);
+        }
+    }
+
+}
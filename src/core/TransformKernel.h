@@ -0,0 +1,51 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Batched translate * rotate * scale -> 4x4 matrix composition over SoA
+// inputs, 8 (AVX2) or 4 (SSE) transforms per step with a scalar tail.
+// Output matrices are column-major, 16 floats each, laid out like
+// glm::mat4, and equal glm's translate(I, p) * mat4_cast(q) * scale(s)
+// element for element (the kernel uses the same operation order and no
+// FMA; only the sign of exact zeros may differ).
+//
+// Only the quaternion products and matrix assembly are vectorized; Euler
+// inputs still take one scalar sin/cos per angle, so quaternion storage
+// is the faster path when available.
+
+namespace xform {
+
+    enum class Isa : uint8_t { Scalar, SSE, AVX2 };
+
+    // Best instruction set this CPU and build support.
+    Isa DetectIsa();
+    Isa ActiveIsa();
+    // Forces a lower ISA (clamped to DetectIsa()); for benches and checks.
+    void SetIsa(Isa isa);
+    const char* IsaName(Isa isa);
+
+    // One array of count floats per field. Euler angles are XYZ radians,
+    // quaternions are (x, y, z, w) and need not be normalized for
+    // equivalence with glm, which does not normalize either.
+    struct TrsSoA {
+        const float* px = nullptr;
+        const float* py = nullptr;
+        const float* pz = nullptr;
+        const float* rx = nullptr;
+        const float* ry = nullptr;
+        const float* rz = nullptr;
+        const float* qx = nullptr;
+        const float* qy = nullptr;
+        const float* qz = nullptr;
+        const float* qw = nullptr;
+        const float* sx = nullptr;
+        const float* sy = nullptr;
+        const float* sz = nullptr;
+    };
+
+    // Uses rx/ry/rz.
+    void ComposeEuler(const TrsSoA& in, std::size_t count, float* out);
+    // Uses qx/qy/qz/qw.
+    void ComposeQuat(const TrsSoA& in, std::size_t count, float* out);
+
+}
@@ -0,0 +1,198 @@
+#include "ArchetypeStorage.h"
+
+#include <algorithm>
+
+namespace {
+    std::size_t AlignUp(std::size_t v, std::size_t a) {
+        return (v + a - 1) & ~(a - 1);
+    }
+
+    std::byte* AllocateChunk(std::size_t bytes) {
+        return static_cast<std::byte*>(::operator new(bytes, std::align_val_t{ ARCHETYPE_CHUNK_ALIGN }));
+    }
+
+    void FreeChunk(std::byte* data) {
+        ::operator delete(data, std::align_val_t{ ARCHETYPE_CHUNK_ALIGN });
+    }
+}
+
+ArchetypeStorage::~ArchetypeStorage() {
+    for (Archetype& a : mArchetypes) {
+        for (std::uint32_t row = 0; row < a.size; ++row) {
+            for (ComponentType t : a.types) {
+                mInfos[t].destroy(ComponentPtr(a, row, t));
+            }
+        }
+        for (ArchetypeChunk& chunk : a.chunks) {
+            FreeChunk(chunk.data);
+        }
+    }
+}
+
+void ArchetypeStorage::EntityDestroyed(Entity e) {
+    if (!Find(e)) return;
+    EntityLocation& loc = mLocations[EntityIndex(e)];
+    RemoveRow(loc.archetype, loc.row);
+    loc = EntityLocation{};
+}
+
+std::size_t ArchetypeStorage::ChunkCount() const {
+    std::size_t n = 0;
+    for (const Archetype& a : mArchetypes) n += a.chunks.size();
+    return n;
+}
+
+std::size_t ArchetypeStorage::BytesReserved() const {
+    std::size_t bytes = mLocations.capacity() * sizeof(EntityLocation);
+    for (const Archetype& a : mArchetypes) bytes += a.chunks.size() * a.chunkBytes;
+    return bytes;
+}
+
+ArchetypeStorage::EntityLocation& ArchetypeStorage::Location(Entity e) {
+    assert(e != INVALID_ENTITY && "Invalid entity.");
+    const std::uint32_t slot = EntityIndex(e);
+    if (slot >= mLocations.size()) {
+        mLocations.resize(std::size_t(slot) + 1);
+    }
+    EntityLocation& loc = mLocations[slot];
+    assert((loc.archetype == Archetype::INVALID || loc.entity == e) && "Stale entity handle: its slot belongs to another entity.");
+    return loc;
+}
+
+const ArchetypeStorage::EntityLocation* ArchetypeStorage::Find(Entity e) const {
+    const std::uint32_t slot = EntityIndex(e);
+    if (slot >= mLocations.size()) return nullptr;
+    const EntityLocation& loc = mLocations[slot];
+    if (loc.archetype == Archetype::INVALID || loc.entity != e) return nullptr;
+    return &loc;
+}
+
+std::uint32_t ArchetypeStorage::GetOrCreateArchetype(const Signature& signature) {
+    const auto it = mArchetypeLookup.find(signature);
+    if (it != mArchetypeLookup.end()) return it->second;
+
+    Archetype a;
+    a.signature = signature;
+    a.columnOffset.fill(Archetype::INVALID);
+    a.addEdge.fill(Archetype::INVALID);
+    a.removeEdge.fill(Archetype::INVALID);
+
+    std::size_t rowBytes = sizeof(Entity);
+    for (std::size_t t = 0; t < MAX_COMPONENTS; ++t) {
+        if (!signature.test(t)) continue;
+        a.types.push_back(static_cast<ComponentType>(t));
+        rowBytes += mInfos[t].size;
+    }
+
+    // Lay out columns for a given capacity; returns the total byte size.
+    auto layout = [&](std::uint32_t capacity) {
+        std::size_t offset = sizeof(Entity) * std::size_t(capacity);
+        for (ComponentType t : a.types) {
+            offset = AlignUp(offset, mInfos[t].align);
+            a.columnOffset[t] = static_cast<std::uint32_t>(offset);
+            offset += mInfos[t].size * std::size_t(capacity);
+        }
+        return offset;
+    };
+
+    std::uint32_t capacity = static_cast<std::uint32_t>(std::max<std::size_t>(1, ARCHETYPE_CHUNK_BYTES / rowBytes));
+    while (capacity > 1 && layout(capacity) > ARCHETYPE_CHUNK_BYTES) {
+        --capacity;
+    }
+    a.chunkCapacity = capacity;
+    a.chunkBytes = AlignUp(std::max(ARCHETYPE_CHUNK_BYTES, layout(capacity)), ARCHETYPE_CHUNK_ALIGN);
+
+    const auto index = static_cast<std::uint32_t>(mArchetypes.size());
+    mArchetypes.push_back(std::move(a));
+    mArchetypeLookup.emplace(signature, index);
+    return index;
+}
+
+std::uint32_t ArchetypeStorage::AddEdge(std::uint32_t archetype, ComponentType type) {
+    const std::uint32_t cached = mArchetypes[archetype].addEdge[type];
+    if (cached != Archetype::INVALID) return cached;
+
+    Signature sig = mArchetypes[archetype].signature;
+    sig.set(type);
+    const std::uint32_t dst = GetOrCreateArchetype(sig);
+    mArchetypes[archetype].addEdge[type] = dst;
+    mArchetypes[dst].removeEdge[type] = archetype;
+    return dst;
+}
+
+std::uint32_t ArchetypeStorage::RemoveEdge(std::uint32_t archetype, ComponentType type) {
+    const std::uint32_t cached = mArchetypes[archetype].removeEdge[type];
+    if (cached != Archetype::INVALID) return cached;
+
+    Signature sig = mArchetypes[archetype].signature;
+    sig.reset(type);
+    if (sig.none()) return Archetype::INVALID;
+
+    const std::uint32_t dst = GetOrCreateArchetype(sig);
+    mArchetypes[archetype].removeEdge[type] = dst;
+    mArchetypes[dst].addEdge[type] = archetype;
+    return dst;
+}
+
+std::uint32_t ArchetypeStorage::AllocateRow(Archetype& a, Entity e) {
+    const std::uint32_t row = a.size;
+    const std::uint32_t chunkIndex = row / a.chunkCapacity;
+    if (chunkIndex == a.chunks.size()) {
+        a.chunks.push_back(ArchetypeChunk{ AllocateChunk(a.chunkBytes), 0 });
+    }
+
+    ArchetypeChunk& chunk = a.chunks[chunkIndex];
+    reinterpret_cast<Entity*>(chunk.data)[row % a.chunkCapacity] = e;
+    ++chunk.count;
+    ++a.size;
+    return row;
+}
+
+void ArchetypeStorage::RemoveRow(std::uint32_t archetype, std::uint32_t row) {
+    Archetype& a = mArchetypes[archetype];
+    assert(row < a.size && "Archetype row out of range.");
+
+    for (ComponentType t : a.types) {
+        mInfos[t].destroy(ComponentPtr(a, row, t));
+    }
+
+    // Keep chunks packed: backfill the hole with the archetype's last row.
+    const std::uint32_t last = a.size - 1;
+    if (row != last) {
+        for (ComponentType t : a.types) {
+            std::byte* src = ComponentPtr(a, last, t);
+            mInfos[t].moveConstruct(ComponentPtr(a, row, t), src);
+            mInfos[t].destroy(src);
+        }
+
+        const Entity moved = reinterpret_cast<Entity*>(a.chunks[last / a.chunkCapacity].data)[last % a.chunkCapacity];
+        reinterpret_cast<Entity*>(a.chunks[row / a.chunkCapacity].data)[row % a.chunkCapacity] = moved;
+        mLocations[EntityIndex(moved)].row = row;
+    }
+
+    ArchetypeChunk& tail = a.chunks.back();
+    --tail.count;
+    --a.size;
+    if (tail.count == 0) {
+        FreeChunk(tail.data);
+        a.chunks.pop_back();
+    }
+}
+
+void ArchetypeStorage::MoveEntity(Entity e, std::uint32_t dstArchetype) {
+    const EntityLocation src = Location(e);
+    Archetype& dst = mArchetypes[dstArchetype];
+    const std::uint32_t dstRow = AllocateRow(dst, e);
+
+    if (src.archetype != Archetype::INVALID) {
+        Archetype& from = mArchetypes[src.archetype];
+        for (ComponentType t : from.types) {
+            if (dst.signature.test(t)) {
+                mInfos[t].moveConstruct(ComponentPtr(dst, dstRow, t), ComponentPtr(from, src.row, t));
+            }
+        }
+        RemoveRow(src.archetype, src.row);
+    }
+
+    mLocations[EntityIndex(e)] = EntityLocation{ e, dstArchetype, dstRow };
+}
@@ -0,0 +1,239 @@
+#pragma once
+
+#include "ComponentTypes.h"
+#include "Entity.h"
+#include "TypeId.h"
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Archetype storage: entities with the same Signature live together in
+// fixed-size chunks, one SoA column per component type. Iterating several
+// components is a linear walk over matching chunks, and memory grows with
+// the number of live entities rather than with MAX_ENTITIES per type.
+//
+// Exposes the same registration/add/remove/get surface as ComponentManager
+// so it can be used as a drop-in store for chunk-oriented gameplay code.
+
+constexpr std::size_t ARCHETYPE_CHUNK_BYTES = 16 * 1024;
+constexpr std::size_t ARCHETYPE_CHUNK_ALIGN = 64;
+
+struct ArchetypeComponentInfo {
+    std::size_t size = 0;
+    std::size_t align = 0;
+    void (*moveConstruct)(void* dst, void* src) = nullptr;
+    void (*destroy)(void* ptr) = nullptr;
+};
+
+struct ArchetypeChunk {
+    std::byte*    data = nullptr;
+    std::uint32_t count = 0;
+};
+
+struct Archetype {
+    static constexpr std::uint32_t INVALID = std::numeric_limits<std::uint32_t>::max();
+
+    Signature                                 signature;
+    std::vector<ComponentType>                types;
+    std::array<std::uint32_t, MAX_COMPONENTS> columnOffset{};
+    std::array<std::uint32_t, MAX_COMPONENTS> addEdge{};
+    std::array<std::uint32_t, MAX_COMPONENTS> removeEdge{};
+    std::uint32_t                             chunkCapacity = 0;
+    std::size_t                               chunkBytes = 0;
+    std::vector<ArchetypeChunk>               chunks;
+    std::uint32_t                             size = 0;
+};
+
+class ArchetypeStorage {
+public:
+    ArchetypeStorage() = default;
+    ~ArchetypeStorage();
+
+    ArchetypeStorage(const ArchetypeStorage&) = delete;
+    ArchetypeStorage& operator=(const ArchetypeStorage&) = delete;
+
+    template<typename T>
+    void RegisterComponent();
+
+    template<typename T>
+    ComponentType GetComponentType() const;
+
+    template<typename T>
+    void AddComponent(Entity e, T component);
+
+    template<typename T>
+    void RemoveComponent(Entity e);
+
+    template<typename T>
+    T& GetComponent(Entity e);
+
+    template<typename T>
+    bool HasComponent(Entity e) const;
+
+    void EntityDestroyed(Entity e);
+
+    // fn(Entity, Ts&...) for every entity owning all of Ts, chunk by chunk.
+    template<typename... Ts, typename Fn>
+    void ForEach(Fn&& fn);
+
+    std::size_t ArchetypeCount() const { return mArchetypes.size(); }
+    std::size_t ChunkCount() const;
+    std::size_t BytesReserved() const;
+
+private:
+    // Keyed by slot; entity tells a live handle from a stale one that
+    // shares its slot.
+    struct EntityLocation {
+        Entity        entity = INVALID_ENTITY;
+        std::uint32_t archetype = Archetype::INVALID;
+        std::uint32_t row = 0;
+    };
+
+    EntityLocation&       Location(Entity e);
+    const EntityLocation* Find(Entity e) const;    // null unless e owns a row
+    std::uint32_t   GetOrCreateArchetype(const Signature& signature);
+    std::uint32_t   AddEdge(std::uint32_t archetype, ComponentType type);
+    std::uint32_t   RemoveEdge(std::uint32_t archetype, ComponentType type);
+    std::uint32_t   AllocateRow(Archetype& a, Entity e);
+    void            RemoveRow(std::uint32_t archetype, std::uint32_t row);
+    void            MoveEntity(Entity e, std::uint32_t dstArchetype);
+
+    std::byte* ComponentPtr(Archetype& a, std::uint32_t row, ComponentType type) {
+        ArchetypeChunk& chunk = a.chunks[row / a.chunkCapacity];
+        const std::uint32_t r = row % a.chunkCapacity;
+        return chunk.data + a.columnOffset[type] + std::size_t(r) * mInfos[type].size;
+    }
+
+    template<typename Fn, typename... Ts, std::size_t... Is>
+    void ForEachImpl(Fn& fn, const std::array<ComponentType, sizeof...(Ts)>& types,
+        std::index_sequence<Is...>);
+
+    static constexpr ComponentType UNREGISTERED = std::numeric_limits<ComponentType>::max();
+
+    ComponentType                                      mNextComponentType{ 0 };
+    std::vector<ComponentType>                         mComponentTypes;    // by ComponentTypeId<T>()
+    std::array<ArchetypeComponentInfo, MAX_COMPONENTS> mInfos{};
+
+    std::vector<Archetype>                             mArchetypes;
+    std::unordered_map<Signature, std::uint32_t>       mArchetypeLookup;
+    std::vector<EntityLocation>                        mLocations;
+};
+
+template<typename T>
+void ArchetypeStorage::RegisterComponent() {
+    static_assert(alignof(T) <= ARCHETYPE_CHUNK_ALIGN, "Component alignment exceeds chunk alignment.");
+    const std::size_t id = ComponentTypeId<T>();
+    if (id >= mComponentTypes.size()) {
+        mComponentTypes.resize(id + 1, UNREGISTERED);
+    }
+    assert(mComponentTypes[id] == UNREGISTERED);
+    assert(mNextComponentType < MAX_COMPONENTS && "Too many component types.");
+
+    const ComponentType type = mNextComponentType++;
+    mComponentTypes[id] = type;
+
+    ArchetypeComponentInfo& info = mInfos[type];
+    info.size = sizeof(T);
+    info.align = alignof(T);
+    info.moveConstruct = [](void* dst, void* src) {
+        new (dst) T(std::move(*static_cast<T*>(src)));
+    };
+    info.destroy = [](void* ptr) {
+        static_cast<T*>(ptr)->~T();
+    };
+}
+
+template<typename T>
+ComponentType ArchetypeStorage::GetComponentType() const {
+    const std::size_t id = ComponentTypeId<T>();
+    assert(id < mComponentTypes.size() && mComponentTypes[id] != UNREGISTERED);
+    return mComponentTypes[id];
+}
+
+template<typename T>
+void ArchetypeStorage::AddComponent(Entity e, T component) {
+    const ComponentType type = GetComponentType<T>();
+    const EntityLocation loc = Location(e);
+
+    std::uint32_t dst;
+    if (loc.archetype == Archetype::INVALID) {
+        Signature sig;
+        sig.set(type);
+        dst = GetOrCreateArchetype(sig);
+    }
+    else {
+        assert(!mArchetypes[loc.archetype].signature.test(type) && "Component added twice to the same entity.");
+        dst = AddEdge(loc.archetype, type);
+    }
+
+    MoveEntity(e, dst);
+    const EntityLocation& moved = Location(e);
+    new (ComponentPtr(mArchetypes[dst], moved.row, type)) T(std::move(component));
+}
+
+template<typename T>
+void ArchetypeStorage::RemoveComponent(Entity e) {
+    const ComponentType type = GetComponentType<T>();
+    EntityLocation& loc = Location(e);
+    assert(loc.archetype != Archetype::INVALID && loc.entity == e && "Removing non-existent component.");
+    assert(mArchetypes[loc.archetype].signature.test(type) && "Removing non-existent component.");
+
+    const std::uint32_t dst = RemoveEdge(loc.archetype, type);
+    if (dst == Archetype::INVALID) {
+        RemoveRow(loc.archetype, loc.row);
+        Location(e) = EntityLocation{};
+    }
+    else {
+        MoveEntity(e, dst);
+    }
+}
+
+template<typename T>
+T& ArchetypeStorage::GetComponent(Entity e) {
+    const ComponentType type = GetComponentType<T>();
+    const EntityLocation& loc = Location(e);
+    assert(loc.archetype != Archetype::INVALID && loc.entity == e && "Retrieving non-existent component.");
+    Archetype& a = mArchetypes[loc.archetype];
+    assert(a.signature.test(type) && "Retrieving non-existent component.");
+    return *reinterpret_cast<T*>(ComponentPtr(a, loc.row, type));
+}
+
+template<typename T>
+bool ArchetypeStorage::HasComponent(Entity e) const {
+    const EntityLocation* loc = Find(e);
+    return loc && mArchetypes[loc->archetype].signature.test(GetComponentType<T>());
+}
+
+template<typename... Ts, typename Fn>
+void ArchetypeStorage::ForEach(Fn&& fn) {
+    const std::array<ComponentType, sizeof...(Ts)> types{ GetComponentType<Ts>()... };
+    ForEachImpl<Fn, Ts...>(fn, types, std::index_sequence_for<Ts...>{});
+}
+
+template<typename Fn, typename... Ts, std::size_t... Is>
+void ArchetypeStorage::ForEachImpl(Fn& fn, const std::array<ComponentType, sizeof...(Ts)>& types,
+    std::index_sequence<Is...>)
+{
+    Signature mask;
+    for (ComponentType t : types) mask.set(t);
+
+    for (Archetype& a : mArchetypes) {
+        if ((a.signature & mask) != mask) continue;
+
+        for (ArchetypeChunk& chunk : a.chunks) {
+            Entity* entities = reinterpret_cast<Entity*>(chunk.data);
+            std::tuple<Ts*...> columns{ reinterpret_cast<Ts*>(chunk.data + a.columnOffset[types[Is]])... };
+            for (std::uint32_t i = 0; i < chunk.count; ++i) {
+                fn(entities[i], std::get<Is>(columns)[i]...);
+            }
+        }
+    }
+}
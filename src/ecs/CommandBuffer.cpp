@@ -0,0 +1,63 @@
+#include "CommandBuffer.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+
+void* CommandArena::Allocate(std::size_t size, std::size_t align) {
+    for (;;) {
+        if (mBlock < mBlocks.size()) {
+            Block& block = mBlocks[mBlock];
+            const auto base = reinterpret_cast<std::uintptr_t>(block.data.get());
+            const std::uintptr_t aligned = (base + mOffset + align - 1) & ~(std::uintptr_t(align) - 1);
+            const std::size_t offset = static_cast<std::size_t>(aligned - base);
+            if (offset + size <= block.size) {
+                mOffset = offset + size;
+                return block.data.get() + offset;
+            }
+            ++mBlock;
+            mOffset = 0;
+            continue;
+        }
+
+        Block block;
+        block.size = std::max(BLOCK_BYTES, size + align);
+        block.data = std::make_unique<std::byte[]>(block.size);
+        mBlocks.push_back(std::move(block));
+    }
+}
+
+void CommandArena::Reset() {
+    mBlock = 0;
+    mOffset = 0;
+}
+
+std::size_t CommandArena::BytesReserved() const {
+    std::size_t bytes = 0;
+    for (const Block& block : mBlocks) bytes += block.size;
+    return bytes;
+}
+
+CommandBuffer::~CommandBuffer() {
+    Clear();
+}
+
+Entity CommandBuffer::CreateEntity() {
+    assert(mProvisionalCount < ENTITY_INDEX_MASK && "Too many deferred entity creations.");
+    const Entity provisional = MakeEntity(mProvisionalCount++, ENTITY_PROVISIONAL_GENERATION);
+    mCommands.push_back(Command{ Op::Create, provisional });
+    return provisional;
+}
+
+void CommandBuffer::DestroyEntity(Entity e) {
+    mCommands.push_back(Command{ Op::Destroy, e });
+}
+
+void CommandBuffer::Clear() {
+    for (const Command& cmd : mCommands) {
+        if (cmd.destroy) cmd.destroy(cmd.payload);
+    }
+    mCommands.clear();
+    mArena.Reset();
+    mProvisionalCount = 0;
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "Entity.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+class ECS;
+
+// Linear bump allocator for command payloads. Blocks are kept across
+// Reset() so a buffer that records every frame stops allocating.
+class CommandArena {
+public:
+    static constexpr std::size_t BLOCK_BYTES = 16 * 1024;
+
+    void* Allocate(std::size_t size, std::size_t align);
+    void  Reset();
+
+    std::size_t BytesReserved() const;
+
+private:
+    struct Block {
+        std::unique_ptr<std::byte[]> data;
+        std::size_t                  size = 0;
+    };
+
+    std::vector<Block> mBlocks;
+    std::size_t        mBlock = 0;
+    std::size_t        mOffset = 0;
+};
+
+// Records structural changes (create, destroy, add, remove) for deferred
+// playback by ECS::FlushCommandBuffers(). One buffer is written by one
+// thread; ECS::GetCommandBuffer() hands each thread its own.
+//
+// CreateEntity() returns a provisional handle that is only meaningful to
+// commands recorded in the same buffer; it is mapped to a real entity
+// during playback.
+class CommandBuffer {
+public:
+    CommandBuffer() = default;
+    ~CommandBuffer();
+
+    CommandBuffer(const CommandBuffer&) = delete;
+    CommandBuffer& operator=(const CommandBuffer&) = delete;
+
+    Entity CreateEntity();
+    void   DestroyEntity(Entity e);
+
+    template<typename T>
+    void AddComponent(Entity e, T component);
+
+    template<typename T>
+    void RemoveComponent(Entity e);
+
+    bool        Empty() const { return mCommands.empty(); }
+    std::size_t Size() const { return mCommands.size(); }
+
+    // Drops recorded commands without applying them.
+    void Clear();
+
+    static bool IsProvisional(Entity e) {
+        return e != INVALID_ENTITY && EntityGeneration(e) == ENTITY_PROVISIONAL_GENERATION;
+    }
+
+private:
+    friend class ECS;
+
+    enum class Op : std::uint8_t { Create, Destroy, Add, Remove };
+
+    struct Command {
+        Op     op;
+        Entity entity;
+        void*  payload = nullptr;
+        void (*apply)(ECS& ecs, Entity e, void* payload) = nullptr;
+        void (*destroy)(void* payload) = nullptr;
+    };
+
+    std::vector<Command> mCommands;
+    CommandArena         mArena;
+    std::uint32_t        mProvisionalCount = 0;
+};
+
+template<typename T>
+void CommandBuffer::AddComponent(Entity e, T component) {
+    void* payload = mArena.Allocate(sizeof(T), alignof(T));
+    new (payload) T(std::move(component));
+
+    Command cmd{ Op::Add, e };
+    cmd.payload = payload;
+    // Generic lambdas defer the ECS member lookup until ECS is complete.
+    cmd.apply = [](auto& ecs, Entity target, void* p) {
+        ecs.template ApplyAddComponent<T>(target, std::move(*static_cast<T*>(p)));
+    };
+    cmd.destroy = [](void* p) {
+        static_cast<T*>(p)->~T();
+    };
+    mCommands.push_back(cmd);
+}
+
+template<typename T>
+void CommandBuffer::RemoveComponent(Entity e) {
+    Command cmd{ Op::Remove, e };
+    cmd.apply = [](auto& ecs, Entity target, void*) {
+        ecs.template ApplyRemoveComponent<T>(target);
+    };
+    mCommands.push_back(cmd);
+}
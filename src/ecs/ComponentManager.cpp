@@ -1,7 +1,50 @@
 #include "ComponentManager.h"
 
+ComponentType ComponentManager::AddPool(std::size_t id, std::unique_ptr<IComponentArray> pool, bool shared, const char* name) {
+    if (id >= mComponentTypes.size()) {
+        mComponentTypes.resize(id + 1, UNREGISTERED);
+        mComponentArrays.resize(id + 1);
+        mShared.resize(id + 1, 0);
+    }
+    assert(mComponentTypes[id] == UNREGISTERED);
+    assert(mNextComponentType < MAX_COMPONENTS && "Too many component types.");
+
+    const ComponentType type = mNextComponentType++;
+    mComponentTypes[id] = type;
+    mShared[id] = shared ? 1 : 0;
+    mComponentArrays[id] = std::move(pool);
+    mArrays.push_back(mComponentArrays[id].get());
+    mNames.push_back(name);
+    return type;
+}
+
 void ComponentManager::EntityDestroyed(Entity e) {
-    for (auto& pair : mComponentArrays) {
-        pair.second->EntityDestroyed(e);
+    for (IComponentArray* array : mArrays) {
+        array->EntityDestroyed(e);
+    }
+}
+
+void ComponentManager::EntitiesDestroyed(const Entity* entities, std::size_t count, const Signature* signatures) {
+    // Pool by pool rather than entity by entity, so each pool's tables stay
+    // in cache for the whole batch. mArrays[type] is the pool of type.
+    for (std::size_t type = 0; type < mArrays.size(); ++type) {
+        IComponentArray* array = mArrays[type];
+        for (std::size_t i = 0; i < count; ++i) {
+            if (signatures[i].test(type)) array->EntityDestroyed(entities[i]);
+        }
+    }
+}
+
+void ComponentManager::ClampTicks() {
+    for (IComponentArray* array : mArrays) {
+        array->ClampTicks(mTick);
+    }
+}
+
+std::size_t ComponentManager::BytesReserved() const {
+    std::size_t bytes = 0;
+    for (const IComponentArray* array : mArrays) {
+        bytes += array->BytesReserved();
     }
-}
\ No newline at end of file
+    return bytes;
+}
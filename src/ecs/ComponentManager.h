@@ -2,93 +2,734 @@
 
 #include "ComponentTypes.h"
 #include "Entity.h"
-#include <array>
-#include <unordered_map>
+#include "TypeId.h"
+#include <vector>
 #include <memory>
-#include <typeindex>
+#include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <limits>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+// Memory held by one pool, for telemetry (ComponentManager::EachPoolMemory).
+// bytesUsed is what the live entries need; the rest of bytesReserved is
+// growth slack and sparse-table holes.
+struct PoolMemory {
+    std::size_t capacity = 0;       // entries the packed arrays hold without growing
+    std::size_t live = 0;
+    std::size_t bytesReserved = 0;
+    std::size_t bytesUsed = 0;
+};
 
 struct IComponentArray {
     virtual ~IComponentArray() = default;
     virtual void EntityDestroyed(Entity e) = 0;
+    virtual std::size_t BytesReserved() const = 0;
+    virtual PoolMemory Memory() const = 0;
+    // Pulls stored change ticks up to at most MAX_TICK_AGE behind now.
+    virtual void ClampTicks(ChangeTick /*now*/) {}
 };
 
+// Owning group over a set of pools (see OwningGroup). Pools call back into
+// their group around every add and remove so the packed prefix stays exact.
+class GroupBase {
+public:
+    virtual ~GroupBase() = default;
+
+    // e was just added to one of the owned pools.
+    virtual void OnAdded(Entity e) = 0;
+    // e is about to be removed from one of the owned pools.
+    virtual void OnRemoving(Entity e) = 0;
+
+    // Entities owning every pool of the group: entries [0, Size()) of each.
+    std::size_t Size() const { return mSize; }
+    std::size_t OwnedCount() const { return mOwned; }
+
+protected:
+    explicit GroupBase(std::size_t owned) : mOwned(owned) {}
+
+    std::size_t mSize = 0;
+    std::size_t mOwned;
+};
+
+// Sparse half of a pool: entity slot -> packed index. Flat mode keeps one
+// array sized to the highest slot seen; paged mode splits it into 4 KB
+// pages that are allocated on first use and freed once empty.
+class SparseIndex {
+public:
+    static constexpr std::uint32_t NONE = std::numeric_limits<std::uint32_t>::max();
+
+    explicit SparseIndex(bool paged) : mPaged(paged) {}
+
+    std::uint32_t Get(std::uint32_t slot) const {
+        // mFlat stays empty in paged mode, so dense lookups pay no extra branch.
+        if (slot < mFlat.size()) return mFlat[slot];
+        if (!mPaged) return NONE;
+        const std::uint32_t page = slot >> PAGE_SHIFT;
+        if (page >= mPages.size() || !mPages[page]) return NONE;
+        return mPages[page][slot & PAGE_MASK];
+    }
+
+    // Points slot at a packed index; slot must not hold one yet.
+    void Insert(std::uint32_t slot, std::uint32_t index) {
+        if (!mPaged) {
+            if (slot >= mFlat.size()) mFlat.resize(std::size_t(slot) + 1, NONE);
+            mFlat[slot] = index;
+            return;
+        }
+        const std::uint32_t page = slot >> PAGE_SHIFT;
+        if (page >= mPages.size()) {
+            mPages.resize(std::size_t(page) + 1);
+            mPageUse.resize(std::size_t(page) + 1, 0);
+        }
+        if (!mPages[page]) {
+            mPages[page] = std::make_unique<std::uint32_t[]>(PAGE_SIZE);
+            std::fill_n(mPages[page].get(), PAGE_SIZE, NONE);
+        }
+        mPages[page][slot & PAGE_MASK] = index;
+        ++mPageUse[page];
+    }
+
+    // Repoints a slot that already holds an index (swap-and-pop).
+    void Update(std::uint32_t slot, std::uint32_t index) {
+        if (!mPaged) mFlat[slot] = index;
+        else mPages[slot >> PAGE_SHIFT][slot & PAGE_MASK] = index;
+    }
+
+    void Erase(std::uint32_t slot) {
+        if (!mPaged) {
+            mFlat[slot] = NONE;
+            return;
+        }
+        const std::uint32_t page = slot >> PAGE_SHIFT;
+        mPages[page][slot & PAGE_MASK] = NONE;
+        if (--mPageUse[page] == 0) mPages[page].reset();
+    }
+
+    std::size_t BytesReserved() const {
+        std::size_t bytes = mFlat.capacity() * sizeof(std::uint32_t)
+            + mPages.capacity() * sizeof(mPages[0]) + mPageUse.capacity() * sizeof(std::uint32_t);
+        for (const auto& page : mPages) {
+            if (page) bytes += PAGE_SIZE * sizeof(std::uint32_t);
+        }
+        return bytes;
+    }
+
+private:
+    static constexpr std::uint32_t PAGE_SHIFT = 10;     // 1024 entries = 4 KB
+    static constexpr std::uint32_t PAGE_SIZE = 1u << PAGE_SHIFT;
+    static constexpr std::uint32_t PAGE_MASK = PAGE_SIZE - 1;
+
+    bool                                          mPaged;
+    std::vector<std::uint32_t>                    mFlat;
+    std::vector<std::unique_ptr<std::uint32_t[]>> mPages;
+    std::vector<std::uint32_t>                    mPageUse;
+};
+
+// Packed storage for one component type. Tag pools (empty T only) keep no
+// per-entity data at all: membership is read from the entity's Signature
+// bit, every lookup returns the same shared instance, and Entities() /
+// Size() expose the whole slot table so a view led by a tag scans every
+// slot. Tags carry no change ticks.
 template<typename T>
 class ComponentArray : public IComponentArray {
 public:
-    ComponentArray() {
-        mEntityToIndex.fill(INVALID_INDEX);
+    explicit ComponentArray(StoragePolicy policy = StoragePolicy::Dense)
+        : mEntityToIndex(policy == StoragePolicy::SparsePaged)
+        , mPolicy(policy)
+    {
+        assert((policy != StoragePolicy::Tag || std::is_empty_v<T>) && "Tag storage needs an empty component type.");
     }
+
+    StoragePolicy Policy() const { return mPolicy; }
+    bool          IsTag() const { return std::is_empty_v<T> && mPolicy == StoragePolicy::Tag; }
+
+    // Owning group that keeps this pool's prefix packed, if any.
+    GroupBase* Group() const { return mGroup; }
+    void       SetGroup(GroupBase* group) { mGroup = group; }
+
+    // Tag pools read membership from the entity tables instead of storing it.
+    void BindTag(const std::vector<Entity>* slots, const std::vector<Signature>* signatures, ComponentType bit) {
+        mSlots = slots;
+        mSignatures = signatures;
+        mTagBit = bit;
+    }
+
     void InsertData(Entity e, T component) {
-        assert(e < MAX_ENTITIES && "Entity out of range.");
+        Emplace(e, std::move(component));
+    }
 
-        const size_t currentIndex = mEntityToIndex[e];
-        assert(currentIndex == INVALID_INDEX && "Component added twice to the same entity.");
+    // Constructs the component in place at the end of the packed array.
+    template<typename... Args>
+    T& Emplace(Entity e, Args&&... args) {
+        if constexpr (std::is_empty_v<T>) {
+            if (IsTag()) {
+                static_cast<void>(T(std::forward<Args>(args)...));
+                return TagInstance();
+            }
+        }
+        const std::uint32_t slot = EntityIndex(e);
+        assert(mEntityToIndex.Get(slot) == INVALID_INDEX && "Component added twice to the same entity.");
 
-        const size_t newIndex = mSize;
-        assert(newIndex < MAX_ENTITIES && "ComponentArray is full.");
+        mEntityToIndex.Insert(slot, static_cast<std::uint32_t>(mComponentArray.size()));
+        T& component = mComponentArray.emplace_back(std::forward<Args>(args)...);
+        mIndexToEntity.push_back(e);
+        mAddedTicks.push_back(Now());
+        mChangedTicks.push_back(Now());
+        ResizeBlocks();
+        RaiseBlock(mChangedTicks.size() - 1, Now());
+        if (!mGroup) return component;
 
-        mComponentArray[newIndex] = std::move(component);
-        mEntityToIndex[e] = newIndex;
-        mIndexToEntity[newIndex] = e;
+        // Joining the group moves the entry into the packed prefix.
+        mGroup->OnAdded(e);
+        return mComponentArray[mEntityToIndex.Get(slot)];
+    }
 
-        ++mSize;
+    // Room for n more components without reallocating.
+    void Reserve(std::size_t n) {
+        mComponentArray.reserve(mComponentArray.size() + n);
+        mIndexToEntity.reserve(mIndexToEntity.size() + n);
+        mAddedTicks.reserve(mAddedTicks.size() + n);
+        mChangedTicks.reserve(mChangedTicks.size() + n);
     }
 
-    void RemoveData(Entity e) {
-        assert(e < MAX_ENTITIES && "Entity out of range.");
+    // Appends n components copied byte-for-byte from data (which need not be
+    // aligned), for loaders. Entities must not already have T.
+    void AppendRaw(const Entity* entities, const void* data, std::size_t n) {
+        static_assert(std::is_trivially_copyable_v<T>, "AppendRaw needs a trivially copyable component.");
+        if constexpr (std::is_empty_v<T>) {
+            if (IsTag()) return;
+        }
+        const std::size_t base = mComponentArray.size();
+        mComponentArray.resize(base + n);
+        if (n) std::memcpy(static_cast<void*>(mComponentArray.data() + base), data, n * sizeof(T));
+        mIndexToEntity.insert(mIndexToEntity.end(), entities, entities + n);
+        mAddedTicks.resize(base + n, Now());
+        mChangedTicks.resize(base + n, Now());
+        ResizeBlocks();
+        RaiseBlocks(base, base + n);
+
+        for (std::size_t i = 0; i < n; ++i) {
+            const std::uint32_t slot = EntityIndex(entities[i]);
+            assert(mEntityToIndex.Get(slot) == INVALID_INDEX && "Component added twice to the same entity.");
+            mEntityToIndex.Insert(slot, static_cast<std::uint32_t>(base + i));
+        }
+        if (!mGroup) return;
+        for (std::size_t i = 0; i < n; ++i) mGroup->OnAdded(entities[i]);
+    }
 
-        const size_t indexOfRemoved = mEntityToIndex[e];
-        assert(indexOfRemoved != INVALID_INDEX && "Removing non-existent component.");
+    void RemoveData(Entity e) {
+        if constexpr (std::is_empty_v<T>) {
+            if (IsTag()) return;
+        }
+        if (mGroup) mGroup->OnRemoving(e);
+        const std::uint32_t slot = EntityIndex(e);
+        const std::uint32_t indexOfRemoved = mEntityToIndex.Get(slot);
+        assert(indexOfRemoved != INVALID_INDEX && mIndexToEntity[indexOfRemoved] == e && "Removing non-existent component.");
 
-        const size_t indexOfLast = mSize - 1;
+        const std::uint32_t indexOfLast = static_cast<std::uint32_t>(mComponentArray.size() - 1);
 
         if (indexOfRemoved != indexOfLast) {
             mComponentArray[indexOfRemoved] = std::move(mComponentArray[indexOfLast]);
+            mAddedTicks[indexOfRemoved] = mAddedTicks[indexOfLast];
+            mChangedTicks[indexOfRemoved] = mChangedTicks[indexOfLast];
+            RaiseBlock(indexOfRemoved, mChangedTicks[indexOfRemoved]);
 
             Entity lastEntity = mIndexToEntity[indexOfLast];
             mIndexToEntity[indexOfRemoved] = lastEntity;
-            mEntityToIndex[lastEntity] = indexOfRemoved;
+            mEntityToIndex.Update(EntityIndex(lastEntity), indexOfRemoved);
         }
-        mEntityToIndex[e] = INVALID_INDEX;
-        --mSize;
+        mEntityToIndex.Erase(slot);
+        mComponentArray.pop_back();
+        mIndexToEntity.pop_back();
+        mAddedTicks.pop_back();
+        mChangedTicks.pop_back();
+        ResizeBlocks();
     }
     T& GetData(Entity e) {
-        assert(e < MAX_ENTITIES && "Entity out of range.");
-        const size_t index = mEntityToIndex[e];
-        assert(index != INVALID_INDEX && "Retrieving non-existent component.");
+        if constexpr (std::is_empty_v<T>) {
+            if (IsTag()) {
+                assert(HasTag(e) && "Retrieving non-existent component.");
+                return TagInstance();
+            }
+        }
+        const std::uint32_t index = mEntityToIndex.Get(EntityIndex(e));
+        assert(index != INVALID_INDEX && mIndexToEntity[index] == e && "Retrieving non-existent component.");
         return mComponentArray[index];
     }
 
+    // Packed index of e's component; e must have one. Not for tags.
+    std::uint32_t PackedIndex(Entity e) const {
+        const std::uint32_t index = mEntityToIndex.Get(EntityIndex(e));
+        assert(index != INVALID_INDEX && mIndexToEntity[index] == e && "Entity has no component in this pool.");
+        return index;
+    }
+
+    // Swaps two packed entries along with their ticks; used by groups.
+    void SwapEntries(std::size_t a, std::size_t b) {
+        if (a == b) return;
+        using std::swap;
+        swap(mComponentArray[a], mComponentArray[b]);
+        swap(mIndexToEntity[a], mIndexToEntity[b]);
+        swap(mAddedTicks[a], mAddedTicks[b]);
+        swap(mChangedTicks[a], mChangedTicks[b]);
+        RaiseBlock(a, mChangedTicks[a]);
+        RaiseBlock(b, mChangedTicks[b]);
+        mEntityToIndex.Update(EntityIndex(mIndexToEntity[a]), static_cast<std::uint32_t>(a));
+        mEntityToIndex.Update(EntityIndex(mIndexToEntity[b]), static_cast<std::uint32_t>(b));
+    }
+
+    bool Has(Entity e) const {
+        if constexpr (std::is_empty_v<T>) {
+            if (IsTag()) return HasTag(e);
+        }
+        const std::uint32_t index = mEntityToIndex.Get(EntityIndex(e));
+        return index != INVALID_INDEX && mIndexToEntity[index] == e;
+    }
+
+    // Null when e has no component in this pool; one sparse lookup, no asserts.
+    T* TryGetData(Entity e) {
+        if constexpr (std::is_empty_v<T>) {
+            if (IsTag()) return HasTag(e) ? &TagInstance() : nullptr;
+        }
+        const std::uint32_t index = mEntityToIndex.Get(EntityIndex(e));
+        if (index == INVALID_INDEX || mIndexToEntity[index] != e) return nullptr;
+        return &mComponentArray[index];
+    }
+
+    // Packed views: Data()[i] belongs to Entities()[i] for i < Size(). For
+    // tags these are the slot table and the shared instance instead.
+    std::size_t Size() const {
+        if constexpr (std::is_empty_v<T>) {
+            if (IsTag()) return mSlots ? mSlots->size() : 0;
+        }
+        return mComponentArray.size();
+    }
+    T* Data() {
+        if constexpr (std::is_empty_v<T>) {
+            if (IsTag()) return &TagInstance();
+        }
+        return mComponentArray.data();
+    }
+    const Entity* Entities() const {
+        if constexpr (std::is_empty_v<T>) {
+            if (IsTag()) return mSlots ? mSlots->data() : nullptr;
+        }
+        return mIndexToEntity.data();
+    }
+
+    // Change tracking. Ticks are parallel to Data(); components are stamped
+    // when added, through MarkChanged(), and by views whose callback wrote
+    // T. GetData() does not stamp.
+    void SetClock(const ChangeTick* clock) { mClock = clock; }
+
+    void MarkChanged(Entity e) {
+        if constexpr (std::is_empty_v<T>) {
+            if (IsTag()) return;
+        }
+        const std::uint32_t index = mEntityToIndex.Get(EntityIndex(e));
+        assert(index != INVALID_INDEX && mIndexToEntity[index] == e && "Marking non-existent component.");
+        mChangedTicks[index] = Now();
+        RaiseBlock(index, Now());
+    }
+
+    void MarkChangedAt(std::size_t index) {
+        if constexpr (std::is_empty_v<T>) {
+            if (IsTag()) return;
+        }
+        mChangedTicks[index] = Now();
+        RaiseBlock(index, Now());
+    }
+
+    void RaiseBlocks(std::size_t begin, std::size_t end) {
+        if constexpr (std::is_empty_v<T>) {
+            if (IsTag()) return;
+        }
+        if (begin >= end) return;
+        for (std::size_t i = begin; i < end; i += CHANGE_BLOCK) RaiseBlock(i, Now());
+        RaiseBlock(end - 1, Now());
+    }
+
+    // False when e has no component in this pool, and always for tags.
+    bool ChangedSince(Entity e, ChangeTick since) const {
+        const std::uint32_t index = mEntityToIndex.Get(EntityIndex(e));
+        return index != INVALID_INDEX && mIndexToEntity[index] == e && TickNewer(mChangedTicks[index], since);
+    }
+
+    const ChangeTick* AddedTicks() const { return mAddedTicks.data(); }
+    const ChangeTick* ChangedTicks() const { return mChangedTicks.data(); }
+
+    // fn(index) for every entry changed after since. Each block of
+    // CHANGE_BLOCK entries keeps the newest tick stamped in it, so blocks
+    // with nothing new are skipped without touching their ticks.
+    template<typename Fn>
+    void EachChangedSince(ChangeTick since, Fn&& fn) const {
+        const std::size_t size = mChangedTicks.size();
+        for (std::size_t block = 0; block < mChangedBlocks.size(); ++block) {
+            if (!TickNewer(mChangedBlocks[block], since)) continue;
+            const std::size_t end = std::min(size, (block + 1) * CHANGE_BLOCK);
+            for (std::size_t i = block * CHANGE_BLOCK; i < end; ++i) {
+                if (TickNewer(mChangedTicks[i], since)) fn(i);
+            }
+        }
+    }
+
     void EntityDestroyed(Entity e) override {
-        assert(e < MAX_ENTITIES && "Entity out of range.");
-        const size_t index = mEntityToIndex[e];
-        if (index != INVALID_INDEX) {
+        if (mEntityToIndex.Get(EntityIndex(e)) != INVALID_INDEX) {
             RemoveData(e);
         }
     }
 
+    std::size_t BytesReserved() const override {
+        return mComponentArray.capacity() * sizeof(T)
+            + mIndexToEntity.capacity() * sizeof(Entity)
+            + (mAddedTicks.capacity() + mChangedTicks.capacity() + mChangedBlocks.capacity()) * sizeof(ChangeTick)
+            + mEntityToIndex.BytesReserved();
+    }
+
+    void ClampTicks(ChangeTick now) override {
+        for (ChangeTick& tick : mAddedTicks) tick = ClampTick(tick, now);
+        for (ChangeTick& tick : mChangedTicks) tick = ClampTick(tick, now);
+        for (ChangeTick& tick : mChangedBlocks) tick = ClampTick(tick, now);
+    }
+
+    // Tag pools store nothing per entity and report zeros.
+    PoolMemory Memory() const override {
+        PoolMemory memory;
+        if (IsTag()) return memory;
+        memory.capacity = mComponentArray.capacity();
+        memory.live = mComponentArray.size();
+        memory.bytesReserved = BytesReserved();
+        memory.bytesUsed = memory.live * (sizeof(T) + sizeof(Entity) + 2 * sizeof(ChangeTick) + sizeof(std::uint32_t))
+            + (memory.live + CHANGE_BLOCK - 1) / CHANGE_BLOCK * sizeof(ChangeTick);
+        return memory;
+    }
+
+private:
+    static constexpr std::uint32_t INVALID_INDEX = SparseIndex::NONE;
+
+    static constexpr std::size_t CHANGE_BLOCK = 64;
+
+    ChangeTick Now() const { return mClock ? *mClock : 1; }
+
+    void ResizeBlocks() {
+        mChangedBlocks.resize((mChangedTicks.size() + CHANGE_BLOCK - 1) / CHANGE_BLOCK, 0);
+    }
+
+    // Parallel views stamp neighbouring entries from several workers, so
+    // the shared block entry is accessed atomically; it is only written
+    // when it actually grows.
+    void RaiseBlock(std::size_t index, ChangeTick tick) {
+        std::atomic_ref<ChangeTick> block(mChangedBlocks[index / CHANGE_BLOCK]);
+        if (TickNewer(tick, block.load(std::memory_order_relaxed))) block.store(tick, std::memory_order_relaxed);
+    }
+
+    bool HasTag(Entity e) const {
+        assert(mSlots && mSignatures && "Tag pool used before BindTag().");
+        const std::uint32_t slot = EntityIndex(e);
+        return slot < mSlots->size() && (*mSlots)[slot] == e && (*mSignatures)[slot].test(mTagBit);
+    }
+
+    static T& TagInstance() {
+        static T instance{};
+        return instance;
+    }
+
+    // Packed components plus the sparse slot -> packed index table; all of
+    // them grow with use, so a rarely used type costs next to nothing.
+    std::vector<T>             mComponentArray;
+    SparseIndex                mEntityToIndex;
+    std::vector<Entity>        mIndexToEntity;
+    std::vector<ChangeTick>    mAddedTicks;
+    std::vector<ChangeTick>    mChangedTicks;
+    std::vector<ChangeTick>    mChangedBlocks;     // newest changed tick per CHANGE_BLOCK entries
+    const ChangeTick*          mClock = nullptr;
+
+    StoragePolicy                 mPolicy;
+    GroupBase*                    mGroup = nullptr;
+    const std::vector<Entity>*    mSlots = nullptr;
+    const std::vector<Signature>* mSignatures = nullptr;
+    ComponentType                 mTagBit = 0;
+};
+
+// Flyweight storage: each distinct value is stored once and entities hold a
+// 32-bit index to it. Values are deduplicated by std::hash<T> and
+// operator==, and released when their last entity lets go. EachGroup()
+// visits entities grouped by value, which is the natural batch for
+// instanced drawing. Values are immutable in place (Set() a new one to
+// change an entity), carry no change ticks and are not visible to
+// ComponentView.
+template<typename T>
+class SharedComponentArray : public IComponentArray {
+public:
+    SharedComponentArray()
+        : mEntityToIndex(false)
+    {
+    }
+
+    // Points e at value, adding the component if e has none.
+    void Set(Entity e, const T& value) {
+        const std::uint32_t ref = Acquire(value);
+        const std::uint32_t slot = EntityIndex(e);
+        const std::uint32_t index = mEntityToIndex.Get(slot);
+        if (index != INVALID_INDEX && mIndexToEntity[index] == e) {
+            Release(mValueOf[index]);
+            mValueOf[index] = ref;
+        }
+        else {
+            mEntityToIndex.Insert(slot, static_cast<std::uint32_t>(mIndexToEntity.size()));
+            mIndexToEntity.push_back(e);
+            mValueOf.push_back(ref);
+        }
+        mGroupsDirty = true;
+    }
+
+    // Set() for count entities that have no value yet; value is looked up
+    // once for the batch.
+    void SetAll(const Entity* entities, std::size_t count, const T& value) {
+        if (count == 0) return;
+        const std::uint32_t ref = Acquire(value);
+        mRefCounts[ref] += static_cast<std::uint32_t>(count - 1);
+        mIndexToEntity.reserve(mIndexToEntity.size() + count);
+        mValueOf.reserve(mValueOf.size() + count);
+        for (std::size_t i = 0; i < count; ++i) {
+            assert(!Has(entities[i]) && "SetAll() on an entity that already has the component.");
+            mEntityToIndex.Insert(EntityIndex(entities[i]), static_cast<std::uint32_t>(mIndexToEntity.size()));
+            mIndexToEntity.push_back(entities[i]);
+            mValueOf.push_back(ref);
+        }
+        mGroupsDirty = true;
+    }
+
+    void RemoveData(Entity e) {
+        const std::uint32_t slot = EntityIndex(e);
+        const std::uint32_t indexOfRemoved = mEntityToIndex.Get(slot);
+        assert(indexOfRemoved != INVALID_INDEX && mIndexToEntity[indexOfRemoved] == e && "Removing non-existent component.");
+
+        Release(mValueOf[indexOfRemoved]);
+        const std::uint32_t indexOfLast = static_cast<std::uint32_t>(mIndexToEntity.size() - 1);
+        if (indexOfRemoved != indexOfLast) {
+            const Entity lastEntity = mIndexToEntity[indexOfLast];
+            mIndexToEntity[indexOfRemoved] = lastEntity;
+            mValueOf[indexOfRemoved] = mValueOf[indexOfLast];
+            mEntityToIndex.Update(EntityIndex(lastEntity), indexOfRemoved);
+        }
+        mEntityToIndex.Erase(slot);
+        mIndexToEntity.pop_back();
+        mValueOf.pop_back();
+        mGroupsDirty = true;
+    }
+
+    bool Has(Entity e) const {
+        const std::uint32_t index = mEntityToIndex.Get(EntityIndex(e));
+        return index != INVALID_INDEX && mIndexToEntity[index] == e;
+    }
+
+    const T& GetData(Entity e) const { return *mValues[ValueIndex(e)]; }
+
+    // Index of e's value; entities with equal values get the same index.
+    std::uint32_t ValueIndex(Entity e) const {
+        const std::uint32_t index = mEntityToIndex.Get(EntityIndex(e));
+        assert(index != INVALID_INDEX && mIndexToEntity[index] == e && "Retrieving non-existent component.");
+        return mValueOf[index];
+    }
+
+    std::size_t Size() const { return mIndexToEntity.size(); }
+    std::size_t ValueCount() const { return mValues.size() - mFreeValues.size(); }
+
+    // fn(const T& value, const Entity* entities, std::size_t count) once per
+    // value in use. The grouping is rebuilt with a counting sort after any
+    // membership change, then reused.
+    template<typename Fn>
+    void EachGroup(Fn&& fn) {
+        if (mGroupsDirty) RebuildGroups();
+        for (std::size_t v = 0; v < mValues.size(); ++v) {
+            const std::uint32_t begin = mGroupStart[v];
+            const std::uint32_t end = mGroupStart[v + 1];
+            if (begin != end) fn(static_cast<const T&>(*mValues[v]), mGrouped.data() + begin, std::size_t(end - begin));
+        }
+    }
+
+    void EntityDestroyed(Entity e) override {
+        if (Has(e)) RemoveData(e);
+    }
+
+    std::size_t BytesReserved() const override {
+        return mValues.capacity() * sizeof(std::optional<T>)
+            + (mRefCounts.capacity() + mFreeValues.capacity() + mValueOf.capacity() + mGroupStart.capacity()) * sizeof(std::uint32_t)
+            + (mIndexToEntity.capacity() + mGrouped.capacity()) * sizeof(Entity)
+            + mLookup.size() * (sizeof(std::size_t) + sizeof(std::uint32_t) + 2 * sizeof(void*))
+            + mLookup.bucket_count() * sizeof(void*)
+            + mEntityToIndex.BytesReserved();
+    }
+
+    PoolMemory Memory() const override {
+        PoolMemory memory;
+        memory.capacity = mIndexToEntity.capacity();
+        memory.live = mIndexToEntity.size();
+        memory.bytesReserved = BytesReserved();
+        memory.bytesUsed = memory.live * (2 * sizeof(Entity) + 2 * sizeof(std::uint32_t))
+            + ValueCount() * (sizeof(T) + sizeof(std::uint32_t));
+        return memory;
+    }
+
 private:
-    static constexpr size_t INVALID_INDEX = std::numeric_limits<size_t>::max();
+    static constexpr std::uint32_t INVALID_INDEX = SparseIndex::NONE;
+
+    std::uint32_t Acquire(const T& value) {
+        const std::size_t hash = std::hash<T>{}(value);
+        const auto [first, last] = mLookup.equal_range(hash);
+        for (auto it = first; it != last; ++it) {
+            if (*mValues[it->second] == value) {
+                ++mRefCounts[it->second];
+                return it->second;
+            }
+        }
+
+        std::uint32_t index;
+        if (!mFreeValues.empty()) {
+            index = mFreeValues.back();
+            mFreeValues.pop_back();
+            mValues[index].emplace(value);
+            mRefCounts[index] = 1;
+        }
+        else {
+            index = static_cast<std::uint32_t>(mValues.size());
+            mValues.emplace_back(value);
+            mRefCounts.push_back(1);
+        }
+        mLookup.emplace(hash, index);
+        return index;
+    }
+
+    void Release(std::uint32_t index) {
+        if (--mRefCounts[index] != 0) return;
+
+        const auto [first, last] = mLookup.equal_range(std::hash<T>{}(*mValues[index]));
+        for (auto it = first; it != last; ++it) {
+            if (it->second == index) {
+                mLookup.erase(it);
+                break;
+            }
+        }
+        mValues[index].reset();    // drop whatever the value holds on to
+        mFreeValues.push_back(index);
+    }
+
+    void RebuildGroups() {
+        mGroupStart.assign(mValues.size() + 1, 0);
+        for (const std::uint32_t v : mValueOf) ++mGroupStart[v + 1];
+        for (std::size_t v = 0; v < mValues.size(); ++v) mGroupStart[v + 1] += mGroupStart[v];
+
+        mGrouped.resize(mIndexToEntity.size());
+        std::vector<std::uint32_t> cursor(mGroupStart.begin(), mGroupStart.end() - 1);
+        for (std::size_t i = 0; i < mIndexToEntity.size(); ++i) {
+            mGrouped[cursor[mValueOf[i]]++] = mIndexToEntity[i];
+        }
+        mGroupsDirty = false;
+    }
+
+    // Distinct values, their reference counts, and released value slots
+    // (empty until reused).
+    std::vector<std::optional<T>>                        mValues;
+    std::vector<std::uint32_t>                           mRefCounts;
+    std::vector<std::uint32_t>                           mFreeValues;
+    std::unordered_multimap<std::size_t, std::uint32_t> mLookup;    // hash -> value index
+
+    // Per entity, packed: the entity and the index of its value.
+    SparseIndex                mEntityToIndex;
+    std::vector<Entity>        mIndexToEntity;
+    std::vector<std::uint32_t> mValueOf;
 
-    std::array<T, MAX_ENTITIES>   mComponentArray{};
-    std::array<size_t, MAX_ENTITIES> mEntityToIndex{};
-    std::array<Entity, MAX_ENTITIES> mIndexToEntity{};
-    size_t                        mSize{ 0 };
+    // Entities sorted by value; group v is [mGroupStart[v], mGroupStart[v + 1]).
+    std::vector<Entity>        mGrouped;
+    std::vector<std::uint32_t> mGroupStart;
+    bool                       mGroupsDirty = true;
+};
+
+// EnTT-style owning group. Each owned pool keeps the entities that have all
+// of Ts in its first Size() entries, in the same order across pools, so a
+// join over exactly Ts is a linear scan of parallel arrays. Entries move
+// into and out of the prefix by swapping as components are added and
+// removed. A pool can belong to one group at most.
+template<typename... Ts>
+class OwningGroup : public GroupBase {
+public:
+    explicit OwningGroup(ComponentArray<Ts>*... pools)
+        : GroupBase(sizeof...(Ts))
+        , mPools{ pools... }
+    {
+    }
+
+    void OnAdded(Entity e) override {
+        if (!std::apply([e](auto*... pools) { return (pools->Has(e) && ...); }, mPools)) return;
+        const std::size_t target = mSize++;
+        std::apply([e, target](auto*... pools) { (pools->SwapEntries(pools->PackedIndex(e), target), ...); }, mPools);
+    }
+
+    void OnRemoving(Entity e) override {
+        auto* first = std::get<0>(mPools);
+        if (!first->Has(e) || first->PackedIndex(e) >= mSize) return;
+        const std::size_t target = --mSize;
+        std::apply([e, target](auto*... pools) { (pools->SwapEntries(pools->PackedIndex(e), target), ...); }, mPools);
+    }
+
+    // Pulls in the entities that already own every pool.
+    void Build() {
+        auto* first = std::get<0>(mPools);
+        for (std::size_t i = 0; i < first->Size(); ++i) OnAdded(first->Entities()[i]);
+    }
+
+private:
+    std::tuple<ComponentArray<Ts>*...> mPools;
 };
 
 class ComponentManager {
 public:
     template<typename T>
-    void RegisterComponent();
+    void RegisterComponent(StoragePolicy policy = StoragePolicy::Dense);
+
+    template<typename T>
+    StoragePolicy GetStoragePolicy() { return GetComponentArray<T>()->Policy(); }
+
+    // Registers T with flyweight storage; see SharedComponentArray. T needs
+    // operator==, a std::hash specialization and IsSharedComponent<T>.
+    template<typename T>
+    void RegisterSharedComponent();
+
+    // Makes Ts an owning group; see OwningGroup. Each pool must be a dense
+    // or sparse-paged pool not already owned by another group.
+    template<typename... Ts>
+    void RegisterGroup();
+
+    template<typename T>
+    bool IsShared() const {
+        const std::size_t id = ComponentTypeId<T>();
+        return id < mShared.size() && mShared[id];
+    }
 
     template<typename T>
     ComponentType GetComponentType();
 
+    template<typename T>
+    bool IsRegistered() const {
+        const std::size_t id = ComponentTypeId<T>();
+        return id < mComponentTypes.size() && mComponentTypes[id] != UNREGISTERED;
+    }
+
     template<typename T>
     void AddComponent(Entity e, T component);
 
+    template<typename T, typename... Args>
+    T& EmplaceComponent(Entity e, Args&&... args);
+
     template<typename T>
     void RemoveComponent(Entity e);
 
@@ -97,34 +738,108 @@ public:
 
     void EntityDestroyed(Entity e);
 
-private:
+    // Batch form of EntityDestroyed. signatures[i] is what entities[i] held,
+    // so each pool only visits the entities that were in it.
+    void EntitiesDestroyed(const Entity* entities, std::size_t count, const Signature* signatures);
+
+    // Non-owning pool pointer; stays valid for the lifetime of the manager.
     template<typename T>
-    std::shared_ptr<ComponentArray<T>> GetComponentArray();
+    ComponentArray<T>* GetComponentArray();
 
-    ComponentType                                      mNextComponentType{ 0 };
-    std::unordered_map<std::type_index, ComponentType> mComponentTypes;
-    std::unordered_map<std::type_index,
-        std::shared_ptr<IComponentArray>>              mComponentArrays;
+    template<typename T>
+    SharedComponentArray<T>* GetSharedArray();
+
+    ChangeTick  CurrentTick() const { return mTick; }
+    void        AdvanceTick() { mTick = NextTick(mTick); }
+    ChangeTick* Clock() { return &mTick; }
+
+    // Entity tables that tag pools read membership from. Must be set before
+    // any tag component is registered.
+    void SetEntityTables(const std::vector<Entity>* slots, const std::vector<Signature>* signatures) {
+        mSlots = slots;
+        mSignatures = signatures;
+    }
+
+    // Heap bytes held by every pool.
+    std::size_t BytesReserved() const;
+
+    // Clamps every pool's stored ticks; see ChangeTick.
+    void ClampTicks();
+
+    // fn(name, memory) for every registered pool, in registration order.
+    template<typename Fn>
+    void EachPoolMemory(Fn&& fn) const {
+        for (std::size_t i = 0; i < mArrays.size(); ++i) fn(mNames[i], mArrays[i]->Memory());
+    }
+
+private:
+    static constexpr ComponentType UNREGISTERED = std::numeric_limits<ComponentType>::max();
+
+    // Assigns the next component type to id and takes ownership of its pool.
+    ComponentType AddPool(std::size_t id, std::unique_ptr<IComponentArray> pool, bool shared, const char* name);
+
+    // Both indexed by ComponentTypeId<T>(); mArrays lists registered pools densely.
+    ComponentType                                 mNextComponentType{ 0 };
+    std::vector<ComponentType>                    mComponentTypes;
+    std::vector<std::unique_ptr<IComponentArray>> mComponentArrays;
+    std::vector<IComponentArray*>                 mArrays;
+    std::vector<const char*>                      mNames;          // parallel to mArrays
+    std::vector<std::uint8_t>                     mShared;
+    std::vector<std::unique_ptr<GroupBase>>       mGroups;
+
+    // Shared by every pool. Advanced on the main thread between system
+    // waves, so workers only ever read it.
+    ChangeTick                                    mTick = 1;
+
+    const std::vector<Entity>*                    mSlots = nullptr;
+    const std::vector<Signature>*                 mSignatures = nullptr;
 };
 
 template<typename T>
-void ComponentManager::RegisterComponent() {
-    const auto ti = std::type_index(typeid(T));
-    assert(mComponentTypes.count(ti) == 0);
-    mComponentTypes[ti] = mNextComponentType++;
-    mComponentArrays[ti] = std::make_shared<ComponentArray<T>>();
+void ComponentManager::RegisterComponent(StoragePolicy policy) {
+    static_assert(!IsSharedComponent<T>, "T is marked IsSharedComponent; register it with RegisterSharedComponent().");
+    auto array = std::make_unique<ComponentArray<T>>(policy);
+    array->SetClock(&mTick);
+    ComponentArray<T>* pool = array.get();
+    const ComponentType type = AddPool(ComponentTypeId<T>(), std::move(array), false, TypeName<T>());
+    if (policy == StoragePolicy::Tag) {
+        assert(mSlots && mSignatures && "Tag components need SetEntityTables() first.");
+        pool->BindTag(mSlots, mSignatures, type);
+    }
+}
+
+template<typename T>
+void ComponentManager::RegisterSharedComponent() {
+    static_assert(IsSharedComponent<T>, "Declare IsSharedComponent<T> = true before registering T as shared.");
+    AddPool(ComponentTypeId<T>(), std::make_unique<SharedComponentArray<T>>(), true, TypeName<T>());
+}
+
+template<typename... Ts>
+void ComponentManager::RegisterGroup() {
+    static_assert(sizeof...(Ts) >= 2, "A group needs at least two component types.");
+    auto group = std::make_unique<OwningGroup<Ts...>>(GetComponentArray<Ts>()...);
+    ((assert(!GetComponentArray<Ts>()->Group() && !GetComponentArray<Ts>()->IsTag()
+        && "Pool is a tag or already owned by a group."),
+        GetComponentArray<Ts>()->SetGroup(group.get())), ...);
+    group->Build();
+    mGroups.push_back(std::move(group));
 }
 
 template<typename T>
 ComponentType ComponentManager::GetComponentType() {
-    const auto it = mComponentTypes.find(typeid(T));
-    assert(it != mComponentTypes.end());
-    return it->second;
+    const std::size_t id = ComponentTypeId<T>();
+    assert(id < mComponentTypes.size() && mComponentTypes[id] != UNREGISTERED);
+    return mComponentTypes[id];
 }
 
 template<typename T>
 void ComponentManager::AddComponent(Entity e, T component) {
-    GetComponentArray<T>()->InsertData(e, component);
+    GetComponentArray<T>()->Emplace(e, std::move(component));
+}
+
+template<typename T, typename... Args>
+T& ComponentManager::EmplaceComponent(Entity e, Args&&... args) {
+    return GetComponentArray<T>()->Emplace(e, std::forward<Args>(args)...);
 }
 
 template<typename T>
@@ -138,8 +853,20 @@ T& ComponentManager::GetComponent(Entity e) {
 }
 
 template<typename T>
-std::shared_ptr<ComponentArray<T>> ComponentManager::GetComponentArray() {
-    const auto it = mComponentArrays.find(typeid(T));
-    assert(it != mComponentArrays.end());
-    return std::static_pointer_cast<ComponentArray<T>>(it->second);
+ComponentArray<T>* ComponentManager::GetComponentArray() {
+    static_assert(!IsSharedComponent<T>,
+        "T is a shared component: it has no ComponentArray or mutable T&; use GetSharedArray() "
+        "(ECS: Set/Get/RemoveSharedComponent, EachGroup).");
+    const std::size_t id = ComponentTypeId<T>();
+    assert(id < mComponentArrays.size() && mComponentArrays[id]);
+    assert(!mShared[id] && "Shared components are reached through GetSharedArray().");
+    return static_cast<ComponentArray<T>*>(mComponentArrays[id].get());
+}
+
+template<typename T>
+SharedComponentArray<T>* ComponentManager::GetSharedArray() {
+    static_assert(IsSharedComponent<T>, "T is not a shared component; use GetComponentArray().");
+    const std::size_t id = ComponentTypeId<T>();
+    assert(id < mComponentArrays.size() && mComponentArrays[id] && mShared[id]);
+    return static_cast<SharedComponentArray<T>*>(mComponentArrays[id].get());
 }
@@ -5,8 +5,56 @@
 #include <cstdint>
 
 constexpr std::size_t MAX_COMPONENTS = 32;
-constexpr std::size_t MAX_ENTITIES = 100000;
 
 using ComponentType = std::uint8_t;
 
 using Signature = std::bitset<MAX_COMPONENTS>;
+
+// World clock for change detection. Pools stamp components with the
+// current tick when they are added or changed; a tick of 0 is never issued,
+// so "changed since 0" means "ever".
+//
+// The clock wraps after 2^32 ticks, so ticks are only ever compared through
+// TickNewer, which is right while the two are less than 2^31 apart. ECS
+// keeps that true by clamping every tick it stores to at most MAX_TICK_AGE
+// behind the clock, once per TICK_CLAMP_INTERVAL; a tick held outside the
+// world must be refreshed at least that often.
+using ChangeTick = std::uint32_t;
+
+inline constexpr ChangeTick MAX_TICK_AGE = ChangeTick(1) << 30;
+inline constexpr ChangeTick TICK_CLAMP_INTERVAL = ChangeTick(1) << 29;
+
+// True when tick was stamped after since.
+constexpr bool TickNewer(ChangeTick tick, ChangeTick since) {
+    return tick != 0 && (since == 0 || static_cast<std::int32_t>(tick - since) > 0);
+}
+
+// The tick after tick, skipping 0.
+constexpr ChangeTick NextTick(ChangeTick tick) {
+    return tick + 1 == 0 ? 1 : tick + 1;
+}
+
+// tick, or the oldest tick still allowed at now if it is older than that.
+constexpr ChangeTick ClampTick(ChangeTick tick, ChangeTick now) {
+    if (tick == 0 || now - tick <= MAX_TICK_AGE) return tick;
+    const ChangeTick oldest = now - MAX_TICK_AGE;
+    return oldest == 0 ? 1 : oldest;
+}
+
+// How a component type's pool stores its data, chosen at registration.
+//   Dense       packed array plus a flat slot -> index table sized to the
+//               highest entity slot seen. Best for common components.
+//   SparsePaged packed array plus a slot -> index table split into 4 KB
+//               pages allocated on demand. Best for rare components.
+//   Tag         empty types only; nothing is stored beyond the entity's
+//               Signature bit.
+enum class StoragePolicy : std::uint8_t { Dense, SparsePaged, Tag };
+
+// Marks T as a flyweight component (see SharedComponentArray). Declare it
+// next to the type, before any ECS call names T:
+//   template<> inline constexpr bool IsSharedComponent<MeshRenderer> = true;
+// Shared types must be registered with RegisterSharedComponent; calls that
+// would hand out a mutable T& or a ComponentArray<T> do not compile for
+// them, and add/remove calls go to the shared pool.
+template<typename T>
+inline constexpr bool IsSharedComponent = false;
@@ -1,24 +1,61 @@
 #pragma once
 
+#include "ComponentTypes.h"
+#include "Entity.h"
+
 #include <glm/glm.hpp>
+#include <cstddef>
+#include <functional>
 #include <memory>
 
 struct TextureAsset;
 struct ShaderAsset;
 struct MeshAsset;
 
+// Local transform, relative to the parent when the entity has a Hierarchy.
+// rotation is XYZ Euler angles in radians.
 struct Transform {
     glm::vec3 position = glm::vec3(0.0f);
     glm::vec3 rotation = glm::vec3(0.0f);
     glm::vec3 scale = glm::vec3(1.0f);
 };
 
+// Parent link. Entities without one (or whose parent has no transform) are
+// hierarchy roots.
+struct Hierarchy {
+    Entity parent = INVALID_ENTITY;
+};
+
+// World matrix cached by TransformSystem; read-only for everyone else.
+struct WorldTransform {
+    glm::mat4 matrix = glm::mat4(1.0f);
+};
+
+// Asset references; registered with ECS::RegisterSharedComponent so entities
+// drawing the same mesh/shader/texture share one copy. Equality and hashing
+// go by asset identity.
 struct MeshRenderer {
     std::shared_ptr<MeshAsset>  mesh;
     std::shared_ptr<ShaderAsset> shader;
     std::shared_ptr<TextureAsset> texture;
+
+    bool operator==(const MeshRenderer&) const = default;
+};
+
+template<>
+struct std::hash<MeshRenderer> {
+    std::size_t operator()(const MeshRenderer& r) const noexcept {
+        std::size_t h = std::hash<const void*>{}(r.mesh.get());
+        h ^= std::hash<const void*>{}(r.shader.get()) + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2);
+        h ^= std::hash<const void*>{}(r.texture.get()) + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2);
+        return h;
+    }
 };
 
+template<>
+inline constexpr bool IsSharedComponent<MeshRenderer> = true;
+
+// Usually one per scene; register with StoragePolicy::SparsePaged.
 struct CameraComponent {
     float fovY = glm::radians(45.0f);
     float nearPlane = 0.1f;
@@ -1,11 +1,32 @@
 #include "ECS.h"
 #include "SystemManager.h"
 
+#include <atomic>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace {
+    std::uint64_t NextWorldSerial() {
+        static std::atomic<std::uint64_t> s_next{ 1 };
+        return s_next.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
 ECS::ECS()
     : mEntityManager(std::make_unique<EntityManager>())
     , mComponentManager(std::make_unique<ComponentManager>())
     , mSystemManager(std::make_unique<SystemManager>())
+    , mObservers(std::make_unique<Observers>())
+    , mWorldSerial(NextWorldSerial())
 {
+    mComponentManager->SetEntityTables(&mEntityManager->Slots(), &mEntityManager->Signatures());
+    mEntityManager->SetObservers(mObservers.get());
+    mSystemManager->SetClock(mComponentManager->Clock());
+    mSystemManager->SetSyncPointCallback([this] {
+        FlushCommandBuffers();
+        DispatchObservers();
+    });
 }
 
 ECS::~ECS() = default;
@@ -15,9 +36,22 @@ Entity ECS::CreateEntity() {
 }
 
 void ECS::DestroyEntity(Entity entity) {
+    const Signature sig = mEntityManager->GetSignature(entity);
     mEntityManager->DestroyEntity(entity);
     mComponentManager->EntityDestroyed(entity);
-    mSystemManager->EntityDestroyed(entity);
+    mSystemManager->EntityDestroyed(entity, sig);
+}
+
+void ECS::DestroyEntities(const Entity* entities, std::size_t count) {
+    // Signatures are read first: that also checks every handle before the
+    // batch touches anything.
+    mDestroyedSignatures.resize(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        mDestroyedSignatures[i] = mEntityManager->GetSignature(entities[i]);
+    }
+    mEntityManager->DestroyEntities(entities, count);
+    mComponentManager->EntitiesDestroyed(entities, count, mDestroyedSignatures.data());
+    mSystemManager->EntitiesDestroyed(entities, count, mDestroyedSignatures.data());
 }
 
 void ECS::Update(float dt)
@@ -25,4 +59,134 @@ void ECS::Update(float dt)
     if (mSystemManager) {
         mSystemManager->UpdateAll(dt);
     }
+    // Also covers changes made outside systems since the last sync point.
+    DispatchObservers();
+    ClampChangeTicks();
+}
+
+void ECS::ClampChangeTicks() {
+    const ChangeTick now = mComponentManager->CurrentTick();
+    if (now - mLastTickClamp < TICK_CLAMP_INTERVAL) return;
+    mLastTickClamp = now;
+    mComponentManager->ClampTicks();
+    mSystemManager->ClampTicks(now);
+    mObservers->ClampTicks(now);
+}
+
+CommandBuffer& ECS::GetCommandBuffer() {
+    // Serials are never reused, so entries left behind by destroyed worlds
+    // can't alias a live one.
+    struct CachedBuffer {
+        std::uint64_t  world;
+        CommandBuffer* buffer;
+    };
+    thread_local std::vector<CachedBuffer> t_buffers;
+
+    for (const CachedBuffer& cached : t_buffers) {
+        if (cached.world == mWorldSerial) return *cached.buffer;
+    }
+
+    CommandBuffer* buffer = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mCommandMutex);
+        mCommandBuffers.push_back(std::make_unique<CommandBuffer>());
+        buffer = mCommandBuffers.back().get();
+    }
+    t_buffers.push_back(CachedBuffer{ mWorldSerial, buffer });
+    return *buffer;
+}
+
+void ECS::FlushCommandBuffers() {
+    std::lock_guard<std::mutex> lock(mCommandMutex);
+
+    bool any = false;
+    for (const auto& buffer : mCommandBuffers) any |= !buffer->Empty();
+    if (!any) return;
+
+    for (const auto& buffer : mCommandBuffers) {
+        if (!buffer->Empty()) PlayBack(*buffer);
+    }
+
+    // One membership update per entity, from the signature systems saw
+    // before the flush to the one it ended with.
+    for (const TouchedEntity& touched : mTouched) {
+        if (!mEntityManager->IsAlive(touched.entity)) continue;
+        const Signature& current = mEntityManager->GetSignature(touched.entity);
+        if (current != touched.signature) {
+            mSystemManager->EntitySignatureChanged(touched.entity, touched.signature, current);
+        }
+    }
+    mTouched.clear();
+}
+
+void ECS::PlayBack(CommandBuffer& buffer) {
+    mProvisional.clear();
+
+    auto resolve = [this](Entity e) {
+        if (!CommandBuffer::IsProvisional(e)) return e;
+        const std::uint32_t local = EntityIndex(e);
+        return local < mProvisional.size() ? mProvisional[local] : INVALID_ENTITY;
+    };
+
+    for (const CommandBuffer::Command& cmd : buffer.mCommands) {
+        switch (cmd.op) {
+        case CommandBuffer::Op::Create: {
+            const Entity e = mEntityManager->CreateEntity();
+            mProvisional.push_back(e);
+            TouchDeferred(e);
+            break;
+        }
+        case CommandBuffer::Op::Destroy: {
+            const Entity e = resolve(cmd.entity);
+            if (!mEntityManager->IsAlive(e)) break;
+
+            // Systems only know about the pre-flush signature.
+            const std::uint32_t slot = EntityIndex(e);
+            Signature published = mEntityManager->GetSignature(e);
+            if (slot < mTouchedIndex.size() && mTouchedIndex[slot] < mTouched.size()
+                && mTouched[mTouchedIndex[slot]].entity == e) {
+                published = mTouched[mTouchedIndex[slot]].signature;
+            }
+            mEntityManager->DestroyEntity(e);
+            mComponentManager->EntityDestroyed(e);
+            mSystemManager->EntityDestroyed(e, published);
+            break;
+        }
+        case CommandBuffer::Op::Add:
+        case CommandBuffer::Op::Remove: {
+            const Entity e = resolve(cmd.entity);
+            if (e != INVALID_ENTITY) cmd.apply(*this, e, cmd.payload);
+            break;
+        }
+        }
+    }
+
+    buffer.Clear();
+}
+
+void ECS::DispatchObservers() {
+    mObservers->Dispatch(mComponentManager->CurrentTick());
+    // Later writes must stamp a newer tick than the one just reported up to.
+    if (mObservers->WatchesChanges()) mComponentManager->AdvanceTick();
+}
+
+void ECS::CheckAlive(Entity entity, const char* what) const {
+    if (!mEntityManager->IsAlive(entity)) {
+        throw std::logic_error(std::string("ECS::") + what + " called on a dead entity.");
+    }
+}
+
+bool ECS::TouchDeferred(Entity entity) {
+    if (!mEntityManager->IsAlive(entity)) return false;
+
+    const std::uint32_t slot = EntityIndex(entity);
+    if (slot >= mTouchedIndex.size()) {
+        mTouchedIndex.resize(std::size_t(slot) + 1, std::numeric_limits<std::uint32_t>::max());
+    }
+    const std::uint32_t index = mTouchedIndex[slot];
+    if (index < mTouched.size() && mTouched[index].entity == entity) return true;
+
+    mTouchedIndex[slot] = static_cast<std::uint32_t>(mTouched.size());
+    mTouched.push_back(TouchedEntity{ entity, mEntityManager->GetSignature(entity) });
+    return true;
 }
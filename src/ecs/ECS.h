@@ -1,9 +1,19 @@
 #pragma once
 
+#include <cassert>
+#include <cstdint>
 #include <memory>
+#include <mutex>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+#include "CommandBuffer.h"
 #include "EntityManager.h"
 #include "ComponentManager.h"
+#include "Observers.h"
 #include "SystemManager.h"
+#include "Query.h"
+#include "View.h"
 
 class ECS {
 public:
@@ -12,37 +22,211 @@ public:
 
     Entity CreateEntity();
     void   DestroyEntity(Entity entity);
+    bool   IsAlive(Entity entity) const { return mEntityManager->IsAlive(entity); }
 
+    // See StoragePolicy; Tag is only valid for empty types.
     template<typename T>
-    void RegisterComponent() {
-        mComponentManager->RegisterComponent<T>();
+    void RegisterComponent(StoragePolicy policy = StoragePolicy::Dense) {
+        mComponentManager->RegisterComponent<T>(policy);
     }
 
+    // Flyweight storage for values many entities share (mesh/material
+    // references): equal values are stored once. T must be marked with
+    // IsSharedComponent. Shared components are set and read with the
+    // *SharedComponent calls and visited with EachGroup(); AddComponent,
+    // RemoveComponent, CreateEntities and CommandBuffer route to them too.
+    // They count in signatures like any other component.
+    template<typename T>
+    void RegisterSharedComponent() {
+        mComponentManager->RegisterSharedComponent<T>();
+    }
+
+    // Keeps the pools of Ts sorted so that entities having all of them sit
+    // at the front of each, in the same order; View<Ts...>() over exactly
+    // these types then iterates them as parallel arrays.
+    template<typename... Ts>
+    void RegisterGroup() {
+        mComponentManager->RegisterGroup<Ts...>();
+    }
+
+    template<typename T>
+    bool IsComponentRegistered() const {
+        return mComponentManager->IsRegistered<T>();
+    }
+
+    // Spawns count entities, each with a copy of every prototype component.
+    // Storage is reserved up front and system membership is updated once
+    // for the batch.
+    template<typename... Ts>
+    std::vector<Entity> CreateEntities(std::size_t count, const Ts&... prototypes) {
+        std::vector<Entity> entities(count);
+        Signature sig;
+        (sig.set(mComponentManager->GetComponentType<Ts>()), ...);
+
+        mEntityManager->CreateEntities(static_cast<std::uint32_t>(count), entities.data(), sig);
+        (CopyToAll(entities, prototypes), ...);
+        mSystemManager->EntitiesCreated(entities.data(), count, sig);
+        return entities;
+    }
+
+    // Batch form of DestroyEntity; every handle is checked before any is
+    // destroyed, and one repeated in the batch is destroyed once.
+    void DestroyEntities(const Entity* entities, std::size_t count);
+
     template<typename T>
     void AddComponent(Entity entity, T component) {
-        mComponentManager->AddComponent<T>(entity, component);
+        if constexpr (IsSharedComponent<T>) SetSharedComponent(entity, component);
+        else EmplaceComponent<T>(entity, std::move(component));
+    }
+
+    // Constructs T in place from args.
+    template<typename T, typename... Args>
+    T& EmplaceComponent(Entity entity, Args&&... args) {
+        static_assert(!IsSharedComponent<T>, "Shared components are immutable in place; use SetSharedComponent().");
+        CheckAlive(entity, "EmplaceComponent");
+        T& component = mComponentManager->EmplaceComponent<T>(entity, std::forward<Args>(args)...);
         auto type = mComponentManager->GetComponentType<T>();
-        auto sig = mEntityManager->GetSignature(entity);
+        const auto oldSig = mEntityManager->GetSignature(entity);
+        auto sig = oldSig;
         sig.set(type);
         mEntityManager->SetSignature(entity, sig);
-        mSystemManager->EntitySignatureChanged(entity, sig);
+        mSystemManager->EntitySignatureChanged(entity, oldSig, sig);
+        return component;
     }
 
     template<typename T>
     void RemoveComponent(Entity entity) {
-        mComponentManager->RemoveComponent<T>(entity);
-        auto type = mComponentManager->GetComponentType<T>();
-        auto sig = mEntityManager->GetSignature(entity);
-        sig.reset(type);
+        if constexpr (IsSharedComponent<T>) {
+            RemoveSharedComponent<T>(entity);
+        }
+        else {
+            CheckAlive(entity, "RemoveComponent");
+            mComponentManager->RemoveComponent<T>(entity);
+            auto type = mComponentManager->GetComponentType<T>();
+            const auto oldSig = mEntityManager->GetSignature(entity);
+            auto sig = oldSig;
+            sig.reset(type);
+            mEntityManager->SetSignature(entity, sig);
+            mSystemManager->EntitySignatureChanged(entity, oldSig, sig);
+        }
+    }
+
+    // Points entity at value, adding the component if it has none.
+    template<typename T>
+    void SetSharedComponent(Entity entity, const T& value) {
+        CheckAlive(entity, "SetSharedComponent");
+        auto* pool = mComponentManager->GetSharedArray<T>();
+        const bool added = !pool->Has(entity);
+        pool->Set(entity, value);
+        if (!added) return;
+
+        const auto oldSig = mEntityManager->GetSignature(entity);
+        auto sig = oldSig;
+        sig.set(mComponentManager->GetComponentType<T>());
         mEntityManager->SetSignature(entity, sig);
-        mSystemManager->EntitySignatureChanged(entity, sig);
+        mSystemManager->EntitySignatureChanged(entity, oldSig, sig);
     }
 
+    template<typename T>
+    const T& GetSharedComponent(Entity entity) {
+        CheckAlive(entity, "GetSharedComponent");
+        return mComponentManager->GetSharedArray<T>()->GetData(entity);
+    }
+
+    template<typename T>
+    void RemoveSharedComponent(Entity entity) {
+        CheckAlive(entity, "RemoveSharedComponent");
+        mComponentManager->GetSharedArray<T>()->RemoveData(entity);
+        const auto oldSig = mEntityManager->GetSignature(entity);
+        auto sig = oldSig;
+        sig.reset(mComponentManager->GetComponentType<T>());
+        mEntityManager->SetSignature(entity, sig);
+        mSystemManager->EntitySignatureChanged(entity, oldSig, sig);
+    }
+
+    // fn(const T& value, const Entity* entities, std::size_t count) once per
+    // distinct value of shared component T.
+    template<typename T, typename Fn>
+    void EachGroup(Fn&& fn) {
+        mComponentManager->GetSharedArray<T>()->EachGroup(std::forward<Fn>(fn));
+    }
+
+    // Does not count as a change; call MarkChanged<T>() after writing.
+    // Shared components are read with GetSharedComponent().
     template<typename T>
     T& GetComponent(Entity entity) {
+        CheckAlive(entity, "GetComponent");
         return mComponentManager->GetComponent<T>(entity);
     }
 
+    template<typename T>
+    void MarkChanged(Entity entity) {
+        CheckAlive(entity, "MarkChanged");
+        mComponentManager->GetComponentArray<T>()->MarkChanged(entity);
+    }
+
+    ChangeTick CurrentTick() const { return mComponentManager->CurrentTick(); }
+
+    // Resolves each pool once; see ComponentView for iteration rules.
+    template<typename... Ts>
+    ComponentView<Ts...> View() {
+        return ComponentView<Ts...>(mComponentManager->GetComponentArray<std::remove_const_t<Ts>>()...);
+    }
+
+    // Build masks with ComponentMask<...>(); see Query.
+    Query CreateQuery(Signature required, Signature excluded = {}, Signature optional = {}) {
+        return Query(required, excluded, optional);
+    }
+
+    // Refreshes query, then calls fn(Entity, Ts*...) for each match. Ts may
+    // be const and are looked up per entity; a pointer is null when that
+    // component is absent, which only happens for types the query doesn't
+    // require. Counts as a change for non-const Ts the same way views do.
+    template<typename... Ts, typename Fn>
+    void Each(Query& query, Fn&& fn) {
+        const EntitySet& matches = query.Update(*mEntityManager);
+        const std::tuple<ComponentArray<std::remove_const_t<Ts>>*...> pools{
+            mComponentManager->GetComponentArray<std::remove_const_t<Ts>>()...
+        };
+        for (const Entity e : matches) {
+            std::apply([&](auto*... pool) {
+                fn(e, static_cast<Ts*>(pool->TryGetData(e))...);
+                (MarkIfWritable<Ts>(pool, e), ...);
+            }, pools);
+        }
+    }
+
+    // Batched observers, called at sync points with every entity that
+    // gained, lost or changed T since the last dispatch; see Observers.
+    template<typename T>
+    ObserverId OnAdd(ObserverFn fn) {
+        return mObservers->Watch(ObserverEvent::Add, mComponentManager->GetComponentType<T>(), std::move(fn));
+    }
+
+    template<typename T>
+    ObserverId OnRemove(ObserverFn fn) {
+        return mObservers->Watch(ObserverEvent::Remove, mComponentManager->GetComponentType<T>(), std::move(fn));
+    }
+
+    // Same change rules as views: writes through GetComponent count only
+    // after MarkChanged<T>(). Not for tag components.
+    template<typename T>
+    ObserverId OnChange(ObserverFn fn) {
+        auto* pool = mComponentManager->GetComponentArray<T>();
+        assert(!pool->IsTag() && "Tag components have no change ticks.");
+        const ComponentType type = mComponentManager->GetComponentType<T>();
+        mObservers->SetChangeScan(type, [pool](ChangeTick since, std::vector<Entity>& out) {
+            const Entity* entities = pool->Entities();
+            const ChangeTick* added = pool->AddedTicks();
+            pool->EachChangedSince(since, [&](std::size_t i) {
+                if (!TickNewer(added[i], since)) out.push_back(entities[i]);
+            });
+        });
+        return mObservers->Watch(ObserverEvent::Change, type, std::move(fn));
+    }
+
+    void RemoveObserver(ObserverId id) { mObservers->Unwatch(id); }
+
     template<typename T>
     ComponentType GetComponentType() {
         return mComponentManager->GetComponentType<T>();
@@ -57,14 +241,148 @@ public:
     void SetSystemSignature(Signature signature) {
         mSystemManager->SetSignature<T>(signature);
     }
+
+    template<typename T>
+    void SetSystemAccess(const SystemAccess& access) {
+        mSystemManager->SetAccess<T>(access);
+    }
+
+    template<typename T>
+    void SetSystemSchedule(const SystemSchedule& schedule) {
+        mSystemManager->SetSchedule<T>(schedule);
+    }
+
+    template<typename T>
+    void SetSystemBudget(double ms) {
+        mSystemManager->SetBudget<T>(ms);
+    }
+
+    // Component bitmask for SystemAccess::reads / writes.
+    template<typename... Ts>
+    Signature ComponentMask() {
+        Signature mask;
+        (mask.set(mComponentManager->GetComponentType<Ts>()), ...);
+        return mask;
+    }
     void Update(float dt);
 
+    // Per-thread deferred command buffer for this world. Safe to call from
+    // any thread; each thread always gets the same buffer back. Systems that
+    // run in parallel must make structural changes through it.
+    CommandBuffer& GetCommandBuffer();
+
+    // Plays back every buffer in creation order, then updates system
+    // membership once per touched entity. Runs automatically after each
+    // wave in Update(); must not race with threads still recording.
+    void FlushCommandBuffers();
+
+    // Delivers queued observer events. Runs after FlushCommandBuffers() at
+    // every sync point and once more at the end of Update(); call it
+    // directly to deliver changes made between frames sooner.
+    void DispatchObservers();
+
+    // Keeps every stored change tick within MAX_TICK_AGE of the clock so
+    // comparisons stay right across wraparound. Runs at the end of Update();
+    // does nothing until TICK_CLAMP_INTERVAL ticks have passed.
+    void ClampChangeTicks();
+
     EntityManager& GetEntityManager() { return *mEntityManager; }
     ComponentManager& GetComponentManager() { return *mComponentManager; }
     SystemManager& GetSystemManager() { return *mSystemManager; }
 
 private:
+    friend class CommandBuffer;
+
+    // Deferred playback: storage and signature change immediately, system
+    // membership is settled at the end of FlushCommandBuffers().
+    template<typename T>
+    void ApplyAddComponent(Entity entity, T&& component) {
+        if (!TouchDeferred(entity)) return;
+        bool added;
+        if constexpr (IsSharedComponent<T>) {
+            auto* pool = mComponentManager->GetSharedArray<T>();
+            added = !pool->Has(entity);
+            pool->Set(entity, component);
+        }
+        else {
+            auto* pool = mComponentManager->GetComponentArray<T>();
+            T* existing = pool->TryGetData(entity);
+            added = existing == nullptr;
+            if (added) {
+                pool->Emplace(entity, std::move(component));
+            }
+            else {
+                *existing = std::move(component);
+                pool->MarkChanged(entity);
+            }
+        }
+        if (!added) return;
+        auto sig = mEntityManager->GetSignature(entity);
+        sig.set(mComponentManager->GetComponentType<T>());
+        mEntityManager->SetSignature(entity, sig);
+    }
+
+    template<typename T>
+    void ApplyRemoveComponent(Entity entity) {
+        if (!TouchDeferred(entity)) return;
+        auto* pool = PoolOf<T>();
+        if (!pool->Has(entity)) return;
+        pool->RemoveData(entity);
+        auto sig = mEntityManager->GetSignature(entity);
+        sig.reset(mComponentManager->GetComponentType<T>());
+        mEntityManager->SetSignature(entity, sig);
+    }
+
+    template<typename T, typename Pool>
+    static void MarkIfWritable(Pool* pool, Entity e) {
+        if constexpr (!std::is_const_v<T>) {
+            if (pool->Has(e)) pool->MarkChanged(e);
+        }
+    }
+
+    template<typename T>
+    void CopyToAll(const std::vector<Entity>& entities, const T& prototype) {
+        if constexpr (IsSharedComponent<T>) {
+            mComponentManager->GetSharedArray<T>()->SetAll(entities.data(), entities.size(), prototype);
+        }
+        else {
+            auto* pool = mComponentManager->GetComponentArray<T>();
+            pool->Reserve(entities.size());
+            for (const Entity e : entities) pool->Emplace(e, prototype);
+        }
+    }
+
+    // The shared or regular pool of T, for calls both kinds support.
+    template<typename T>
+    auto* PoolOf() {
+        if constexpr (IsSharedComponent<T>) return mComponentManager->GetSharedArray<T>();
+        else return mComponentManager->GetComponentArray<T>();
+    }
+
+    // Pools key on the slot alone, so a stale handle would reach whichever
+    // entity reuses it; every immediate per-entity call checks first.
+    void CheckAlive(Entity entity, const char* what) const;
+
+    // Records the signature systems last saw for entity; false if it is dead.
+    bool TouchDeferred(Entity entity);
+    void PlayBack(CommandBuffer& buffer);
+
     std::unique_ptr<EntityManager>    mEntityManager;
     std::unique_ptr<ComponentManager> mComponentManager;
     std::unique_ptr<SystemManager>    mSystemManager;
+    std::unique_ptr<Observers>        mObservers;
+
+    struct TouchedEntity {
+        Entity    entity;
+        Signature signature;    // as last published to systems
+    };
+
+    std::uint64_t                               mWorldSerial;
+    ChangeTick                                  mLastTickClamp = 0;
+    std::mutex                                  mCommandMutex;
+    std::vector<std::unique_ptr<CommandBuffer>> mCommandBuffers;
+    std::vector<TouchedEntity>                  mTouched;
+    std::vector<std::uint32_t>                  mTouchedIndex;    // by EntityIndex
+    std::vector<Entity>                         mProvisional;     // per buffer during playback
+    std::vector<Signature>                      mDestroyedSignatures; // scratch for DestroyEntities
 };
@@ -2,6 +2,28 @@
 #include <cstdint>
 #include <limits>
 
+// Entity handles pack a slot index (low bits) and that slot's generation
+// (high bits). Destroying an entity bumps its slot's generation, so stale
+// handles never alias an entity that later reuses the slot.
 using Entity = std::uint32_t;
 
+inline constexpr std::uint32_t ENTITY_INDEX_BITS = 22;
+inline constexpr std::uint32_t ENTITY_GENERATION_BITS = 32 - ENTITY_INDEX_BITS;
+inline constexpr Entity        ENTITY_INDEX_MASK = (Entity(1) << ENTITY_INDEX_BITS) - 1;
+inline constexpr Entity        ENTITY_GENERATION_MASK = (Entity(1) << ENTITY_GENERATION_BITS) - 1;
+
+// Hard ceiling imposed by the handle layout; storage itself grows on demand.
+// The all-ones index is reserved as the free-list terminator.
+inline constexpr std::uint32_t MAX_ENTITIES = ENTITY_INDEX_MASK;
+
 inline constexpr Entity INVALID_ENTITY = std::numeric_limits<Entity>::max();
+
+// Never issued by EntityManager; marks handles handed out by
+// CommandBuffer::CreateEntity() before playback assigns a real slot.
+inline constexpr std::uint32_t ENTITY_PROVISIONAL_GENERATION = ENTITY_GENERATION_MASK;
+
+constexpr std::uint32_t EntityIndex(Entity e) { return e & ENTITY_INDEX_MASK; }
+constexpr std::uint32_t EntityGeneration(Entity e) { return e >> ENTITY_INDEX_BITS; }
+constexpr Entity MakeEntity(std::uint32_t index, std::uint32_t generation) {
+    return (Entity(generation & ENTITY_GENERATION_MASK) << ENTITY_INDEX_BITS) | (index & ENTITY_INDEX_MASK);
+}
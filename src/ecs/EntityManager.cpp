@@ -1,73 +1,148 @@
 #include "EntityManager.h"
+#include "Observers.h"
 
-EntityManager::EntityManager()
-    : mLivingEntityCount(0)
-{
-    // Initially, no entity is alive
-    mAlive.fill(false);
+#include <bit>
+#include <string>
 
-    // Fill the queue with all possible IDs
-    for (Entity e = 0; e < MAX_ENTITIES; ++e) {
-        mAvailableEntities.push(e);
+Entity EntityManager::CreateEntity() {
+    Entity id;
+
+    if (mFreeHead != ENTITY_INDEX_MASK) {
+        id = PopFreeSlot();
+        mSignatures[EntityIndex(id)].reset();
+    }
+    else {
+        if (mSlots.size() >= MAX_ENTITIES) {
+            throw std::runtime_error("Too many entities in existence.");
+        }
+        const auto index = static_cast<std::uint32_t>(mSlots.size());
+        id = MakeEntity(index, 0);
+        mSlots.push_back(id);
+        mSignatures.emplace_back();
     }
+
+    ++mLivingEntityCount;
+    RecordChange(id, Signature{}, Signature{});
+    return id;
 }
 
-Entity EntityManager::CreateEntity() {
-    if (mLivingEntityCount >= MAX_ENTITIES) {
+void EntityManager::CreateEntities(std::uint32_t count, Entity* out, const Signature& signature) {
+    const std::uint32_t freeSlots = static_cast<std::uint32_t>(mSlots.size()) - mLivingEntityCount;
+    const std::uint32_t fresh = count > freeSlots ? count - freeSlots : 0;
+    if (std::size_t(mSlots.size()) + fresh > MAX_ENTITIES) {
         throw std::runtime_error("Too many entities in existence.");
     }
 
-    if (mAvailableEntities.empty()) {
-        throw std::runtime_error("No available entity IDs.");
+    std::uint32_t i = 0;
+    for (; i < count && mFreeHead != ENTITY_INDEX_MASK; ++i) {
+        out[i] = PopFreeSlot();
+        mSignatures[EntityIndex(out[i])] = signature;
     }
 
-    // Grab the next free ID
-    Entity id = mAvailableEntities.front();
-    mAvailableEntities.pop();
-
-    if (mAlive[id]) {
-        throw std::logic_error("EntityManager: CreateEntity returned an ID that is already alive.");
+    const auto base = static_cast<std::uint32_t>(mSlots.size());
+    mSlots.resize(std::size_t(base) + fresh);
+    mSignatures.resize(std::size_t(base) + fresh, signature);
+    for (std::uint32_t k = 0; k < fresh; ++k, ++i) {
+        const Entity id = MakeEntity(base + k, 0);
+        mSlots[base + k] = id;
+        out[i] = id;
     }
 
-    mAlive[id] = true;
-    mSignatures[id].reset();
-    ++mLivingEntityCount;
+    mLivingEntityCount += count;
+    for (std::uint32_t k = 0; k < count; ++k) RecordChange(out[k], Signature{}, signature);
+}
+
+Entity EntityManager::PopFreeSlot() {
+    // Pop the intrusive free list; the slot already holds the next generation.
+    const std::uint32_t index = mFreeHead;
+    const Entity slot = mSlots[index];
+    mFreeHead = EntityIndex(slot);
+    const Entity id = MakeEntity(index, EntityGeneration(slot));
+    mSlots[index] = id;
     return id;
 }
 
 void EntityManager::DestroyEntity(Entity e) {
-    if (e >= MAX_ENTITIES) {
-        throw std::out_of_range("Entity out of range.");
-    }
-    if (!mAlive[e]) {
-        throw std::logic_error("EntityManager::DestroyEntity called on a dead entity.");
-    }
+    CheckAlive(e, "DestroyEntity");
 
-    // Reset signature and mark dead
-    mSignatures[e].reset();
-    mAlive[e] = false;
+    const std::uint32_t index = EntityIndex(e);
+    RecordChange(e, mSignatures[index], Signature{});
+    mSignatures[index].reset();
 
-    // Recycle the ID
-    mAvailableEntities.push(e);
+    PushFreeSlot(e);
     --mLivingEntityCount;
 }
 
-void EntityManager::SetSignature(Entity e, Signature sig) {
-    if (e >= MAX_ENTITIES) {
-        throw std::out_of_range("Entity out of range.");
+void EntityManager::DestroyEntities(const Entity* entities, std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i) CheckAlive(entities[i], "DestroyEntities");
+
+    std::uint32_t destroyed = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        const Entity e = entities[i];
+        const std::uint32_t index = EntityIndex(e);
+        if (mSlots[index] != e) continue;   // repeated in this batch
+
+        RecordChange(e, mSignatures[index], Signature{});
+        mSignatures[index].reset();
+        PushFreeSlot(e);
+        ++destroyed;
     }
-    if (!mAlive[e]) {
-        throw std::logic_error("EntityManager::SetSignature called on a dead entity.");
+    mLivingEntityCount -= destroyed;
+}
+
+void EntityManager::PushFreeSlot(Entity e) {
+    // Bump the generation (skipping the provisional one) and push the slot
+    // onto the free list.
+    const std::uint32_t index = EntityIndex(e);
+    std::uint32_t generation = (EntityGeneration(e) + 1) & ENTITY_GENERATION_MASK;
+    if (generation == ENTITY_PROVISIONAL_GENERATION) generation = 0;
+    mSlots[index] = MakeEntity(mFreeHead, generation);
+    mFreeHead = index;
+}
+
+bool EntityManager::IsAlive(Entity e) const {
+    const std::uint32_t index = EntityIndex(e);
+    return index < mSlots.size() && mSlots[index] == e;
+}
+
+void EntityManager::Reserve(std::uint32_t capacity) {
+    if (capacity > MAX_ENTITIES) {
+        throw std::out_of_range("EntityManager::Reserve exceeds the entity handle range.");
     }
-    mSignatures[e] = sig;
+    mSlots.reserve(capacity);
+    mSignatures.reserve(capacity);
+}
+
+void EntityManager::SetSignature(Entity e, Signature sig) {
+    CheckAlive(e, "SetSignature");
+    Signature& current = mSignatures[EntityIndex(e)];
+    if (current == sig) return;
+    RecordChange(e, current, sig);
+    current = sig;
 }
 
 Signature EntityManager::GetSignature(Entity e) const {
-    if (e >= MAX_ENTITIES) {
+    CheckAlive(e, "GetSignature");
+    return mSignatures[EntityIndex(e)];
+}
+
+void EntityManager::RecordChange(Entity e, const Signature& before, const Signature& after) {
+    if (mObservers) mObservers->Record(e, before, after);
+
+    const Signature changedTypes = before ^ after;
+    ++mEpoch;
+    mChangeLog[mEpoch % CHANGE_LOG_SIZE] = e;
+
+    for (unsigned long bits = changedTypes.to_ulong(); bits; bits &= bits - 1) {
+        mTypeEpochs[std::countr_zero(bits)] = mEpoch;
+    }
+}
+
+void EntityManager::CheckAlive(Entity e, const char* what) const {
+    if (EntityIndex(e) >= mSlots.size()) {
         throw std::out_of_range("Entity out of range.");
     }
-    if (!mAlive[e]) {
-        throw std::logic_error("EntityManager::GetSignature called on a dead entity.");
+    if (mSlots[EntityIndex(e)] != e) {
+        throw std::logic_error(std::string("EntityManager::") + what + " called on a dead entity.");
     }
-    return mSignatures[e];
 }
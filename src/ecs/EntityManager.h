@@ -3,29 +3,92 @@
 #include "Entity.h"
 #include "ComponentTypes.h"
 
-#include <queue>
 #include <array>
+#include <vector>
 #include <cstdint>
 #include <stdexcept>
 #include <bitset>
 
 using Signature = std::bitset<MAX_COMPONENTS>;
 
+class Observers;
+
 class EntityManager {
 public:
-    static constexpr Entity MAX_ENTITIES = static_cast<Entity>(::MAX_ENTITIES);
-
-    EntityManager();
+    EntityManager() = default;
 
     Entity  CreateEntity();
+
+    // Creates count entities with the given signature, writing the handles
+    // to out. Recycled slots are used first, the rest are appended as one
+    // contiguous block.
+    void    CreateEntities(std::uint32_t count, Entity* out, const Signature& signature);
     void    DestroyEntity(Entity e);
+    // Destroys count entities. Every handle is checked before any is
+    // destroyed; a handle repeated in the batch is destroyed once.
+    void    DestroyEntities(const Entity* entities, std::size_t count);
+    bool    IsAlive(Entity e) const;
+
+    // Pre-grows the slot table so the next `capacity` creations don't reallocate.
+    void    Reserve(std::uint32_t capacity);
 
     void    SetSignature(Entity e, Signature sig);
     Signature GetSignature(Entity e) const;
 
+    std::uint32_t LivingCount() const { return mLivingEntityCount; }
+    std::uint32_t Capacity() const { return static_cast<std::uint32_t>(mSlots.size()); }
+
+    // Structural change tracking for cached queries. Every create, destroy
+    // and signature change advances the epoch and is written to a ring of
+    // the last CHANGE_LOG_SIZE changed entities; each component type also
+    // records the last epoch at which any entity gained or lost it.
+    static constexpr std::uint64_t CHANGE_LOG_SIZE = 4096;
+
+    std::uint64_t StructuralEpoch() const { return mEpoch; }
+    std::uint64_t TypeEpoch(ComponentType type) const { return mTypeEpochs[type]; }
+
+    // fn(Entity) for every change after epoch since (entities may repeat and
+    // may be dead by now). False, without calling fn, when the ring no
+    // longer reaches back that far.
+    template<typename Fn>
+    bool ChangesSince(std::uint64_t since, Fn&& fn) const {
+        if (mEpoch - since > CHANGE_LOG_SIZE) return false;
+        for (std::uint64_t epoch = since + 1; epoch <= mEpoch; ++epoch) {
+            fn(mChangeLog[epoch % CHANGE_LOG_SIZE]);
+        }
+        return true;
+    }
+
+    // Raw per-slot tables, for storage that keys membership off signatures
+    // (tag pools). A slot holds its live handle only while alive.
+    const std::vector<Entity>&    Slots() const { return mSlots; }
+    const std::vector<Signature>& Signatures() const { return mSignatures; }
+
+    // Heap bytes of the slot and signature tables and the change log.
+    std::size_t BytesReserved() const {
+        return mSlots.capacity() * sizeof(Entity) + mSignatures.capacity() * sizeof(Signature)
+            + mChangeLog.capacity() * sizeof(Entity);
+    }
+
+    // Receives every signature transition; see Observers.
+    void SetObservers(Observers* observers) { mObservers = observers; }
+
 private:
-    std::queue<Entity>     mAvailableEntities;
-    std::array<Signature, MAX_ENTITIES> mSignatures{};
-    std::array<bool, MAX_ENTITIES>      mAlive{};
-    uint32_t                            mLivingEntityCount;
+    void   CheckAlive(Entity e, const char* what) const;
+    Entity PopFreeSlot();
+    void   PushFreeSlot(Entity e);
+    void   RecordChange(Entity e, const Signature& before, const Signature& after);
+
+    // Live slot: the live handle. Free slot: generation of the next handle to
+    // issue in the high bits, index of the next free slot in the low bits.
+    std::vector<Entity>    mSlots;
+    std::vector<Signature> mSignatures;
+    std::uint32_t          mFreeHead = ENTITY_INDEX_MASK;
+    std::uint32_t          mLivingEntityCount = 0;
+
+    std::uint64_t                              mEpoch = 0;
+    std::array<std::uint64_t, MAX_COMPONENTS>  mTypeEpochs{};
+    std::vector<Entity>                        mChangeLog = std::vector<Entity>(CHANGE_LOG_SIZE, INVALID_ENTITY);
+
+    Observers* mObservers = nullptr;
 };
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "Entity.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+// Sparse set of entity handles: O(1) insert, swap-remove and membership test,
+// with the members packed densely for iteration. Erase does not preserve
+// order. The sparse table is keyed by slot index and grows on demand.
+class EntitySet {
+public:
+    bool Insert(Entity e) {
+        const std::uint32_t slot = EntityIndex(e);
+        if (slot >= mSparse.size()) {
+            mSparse.resize(std::size_t(slot) + 1, INVALID_INDEX);
+        }
+        else if (Contains(e)) {
+            return false;
+        }
+        mSparse[slot] = static_cast<std::uint32_t>(mDense.size());
+        mDense.push_back(e);
+        return true;
+    }
+
+    bool Erase(Entity e) {
+        if (!Contains(e)) return false;
+
+        const std::uint32_t slot = EntityIndex(e);
+        const std::uint32_t index = mSparse[slot];
+        const Entity last = mDense.back();
+        mDense[index] = last;
+        mSparse[EntityIndex(last)] = index;
+        mDense.pop_back();
+        mSparse[slot] = INVALID_INDEX;
+        return true;
+    }
+
+    bool Contains(Entity e) const {
+        const std::uint32_t slot = EntityIndex(e);
+        if (slot >= mSparse.size()) return false;
+        const std::uint32_t index = mSparse[slot];
+        return index != INVALID_INDEX && mDense[index] == e;
+    }
+
+    void Clear() {
+        for (Entity e : mDense) mSparse[EntityIndex(e)] = INVALID_INDEX;
+        mDense.clear();
+    }
+
+    void Reserve(std::size_t n) { mDense.reserve(n); }
+
+    std::size_t   Size() const { return mDense.size(); }
+    bool          Empty() const { return mDense.empty(); }
+    const Entity* Data() const { return mDense.data(); }
+    std::size_t   BytesReserved() const {
+        return mSparse.capacity() * sizeof(std::uint32_t) + mDense.capacity() * sizeof(Entity);
+    }
+    Entity        operator[](std::size_t i) const { return mDense[i]; }
+
+    const Entity* begin() const { return mDense.data(); }
+    const Entity* end() const { return mDense.data() + mDense.size(); }
+
+private:
+    static constexpr std::uint32_t INVALID_INDEX = std::numeric_limits<std::uint32_t>::max();
+
+    std::vector<std::uint32_t> mSparse;
+    std::vector<Entity>        mDense;
+};
@@ -1,12 +1,26 @@
 #pragma once
 
+#include "ComponentTypes.h"
 #include "Entity.h"
-#include <vector>
+#include "EntitySet.h"
+
+#include <cstddef>
 
 class ISystem {
 public:
     virtual ~ISystem() = default;
     virtual void Update(float dt) = 0;
 
-    std::vector<Entity> mEntities;
+    // Called instead of Update() for systems scheduled TimeSliced: one
+    // consecutive run of mEntities per call, several calls per frame until
+    // the slice budget is spent. dt is the time since these entities were
+    // last updated. Structural changes must go through the command buffer,
+    // since mEntities is being walked.
+    virtual void UpdateSlice(float /*dt*/, const Entity* /*entities*/, std::size_t /*count*/) {}
+
+    EntitySet mEntities;
+
+    // Tick of this system's previous update (0 before the first one); pass
+    // it to a view's Changed<T>() / Added<T>() to see only what is new.
+    ChangeTick mLastRunTick = 0;
 };
@@ -0,0 +1,93 @@
+#include "Observers.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+
+ObserverId Observers::Watch(ObserverEvent event, ComponentType type, ObserverFn fn) {
+    assert(type < MAX_COMPONENTS);
+    const ObserverId id = mNextId++;
+    mObservers.push_back(Observer{ id, event, type, std::move(fn) });
+    RebuildMasks();
+    return id;
+}
+
+void Observers::SetChangeScan(ComponentType type, ChangeScanFn scan) {
+    mChangeScans[type] = std::move(scan);
+}
+
+void Observers::Unwatch(ObserverId id) {
+    mObservers.erase(std::remove_if(mObservers.begin(), mObservers.end(),
+        [id](const Observer& observer) { return observer.id == id; }), mObservers.end());
+    RebuildMasks();
+}
+
+void Observers::RebuildMasks() {
+    Signature watchAdd, watchRemove, watchChange;
+    for (const Observer& observer : mObservers) {
+        switch (observer.event) {
+        case ObserverEvent::Add:    watchAdd.set(observer.type); break;
+        case ObserverEvent::Remove: watchRemove.set(observer.type); break;
+        case ObserverEvent::Change: watchChange.set(observer.type); break;
+        }
+    }
+
+    // Types nobody watches anymore drop what they had queued.
+    const Signature watchStructural = watchAdd | watchRemove;
+    for (std::size_t type = 0; type < MAX_COMPONENTS; ++type) {
+        if (!watchStructural.test(type)) mTransitions[type].clear();
+    }
+    mWatchAdd = watchAdd;
+    mWatchRemove = watchRemove;
+    mWatchChange = watchChange;
+    mWatchStructural = watchStructural;
+}
+
+void Observers::Dispatch(ChangeTick now) {
+    const ChangeTick since = mLastDispatch;
+    mLastDispatch = now;
+
+    const Signature watched = mWatchStructural | mWatchChange;
+    for (unsigned long bits = watched.to_ulong(); bits; bits &= bits - 1) {
+        const auto type = static_cast<ComponentType>(std::countr_zero(bits));
+
+        if (!mTransitions[type].empty()) {
+            // Swapping the queue out lets callbacks queue new events safely.
+            mTaken.clear();
+            mTaken.swap(mTransitions[type]);
+            std::stable_sort(mTaken.begin(), mTaken.end(),
+                [](const Transition& a, const Transition& b) { return a.entity < b.entity; });
+
+            // Transitions of one handle alternate, so its first one says
+            // whether it had T at the previous dispatch and its last one
+            // whether it has T now.
+            mBatch.clear();
+            mAddBatch.clear();
+            for (std::size_t i = 0; i < mTaken.size();) {
+                const std::size_t first = i;
+                while (i < mTaken.size() && mTaken[i].entity == mTaken[first].entity) ++i;
+                if (!mTaken[first].added) mBatch.push_back(mTaken[first].entity);
+                if (mTaken[i - 1].added) mAddBatch.push_back(mTaken[i - 1].entity);
+            }
+            Deliver(ObserverEvent::Remove, type);
+            mBatch.swap(mAddBatch);
+            Deliver(ObserverEvent::Add, type);
+        }
+        if (mWatchChange.test(type) && mChangeScans[type]) {
+            mBatch.clear();
+            mChangeScans[type](since, mBatch);
+            std::sort(mBatch.begin(), mBatch.end());
+            Deliver(ObserverEvent::Change, type);
+        }
+    }
+}
+
+void Observers::Deliver(ObserverEvent event, ComponentType type) {
+    if (mBatch.empty()) return;
+    // Indexed: a callback may register more observers.
+    for (std::size_t i = 0; i < mObservers.size(); ++i) {
+        if (mObservers[i].event == event && mObservers[i].type == type) {
+            mObservers[i].fn(mBatch.data(), mBatch.size());
+        }
+    }
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "ComponentTypes.h"
+#include "Entity.h"
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <vector>
+
+// fn(entities, count): one call per observer per dispatch, never empty.
+using ObserverFn = std::function<void(const Entity* entities, std::size_t count)>;
+using ObserverId = std::uint32_t;
+
+enum class ObserverEvent : std::uint8_t { Add, Remove, Change };
+
+// Batched component observers (ECS::OnAdd / OnRemove / OnChange).
+//
+// Adds and removes are queued per component type as EntityManager applies
+// signature changes, so every path that adds or removes components is
+// covered (command buffers, bulk creation, loading). Changes aren't queued:
+// at dispatch the pool's change ticks are scanned for entries stamped
+// since the previous dispatch, and only for types someone observes.
+//
+// Dispatch() runs at every ECS sync point, after deferred commands are
+// flushed, and at the end of ECS::Update. Per type, removes are delivered
+// first, then adds, then changes, each batch sorted and free of
+// duplicates. Adds and removes are netted per handle (so per generation)
+// over the window since the previous dispatch:
+//   Remove  the entity had T at the previous dispatch and lost it since;
+//           it may be destroyed, and the component itself is already gone.
+//   Add     the entity has T now and didn't at the previous dispatch, or
+//           lost and regained it (then it is in both batches).
+//   Change  entities whose T was stamped changed and not added since the
+//           previous dispatch.
+// A T added and removed again within one window is not reported, so every
+// Remove follows an Add or a T that predates the observer.
+// Structural changes made by a callback are delivered at the next dispatch.
+class Observers {
+public:
+    // out receives the entities whose T was changed, but not added, after since.
+    using ChangeScanFn = std::function<void(ChangeTick since, std::vector<Entity>& out)>;
+
+    ObserverId Watch(ObserverEvent event, ComponentType type, ObserverFn fn);
+    void       SetChangeScan(ComponentType type, ChangeScanFn scan);
+    // Not from inside an observer callback.
+    void       Unwatch(ObserverId id);
+
+    bool WatchesChanges() const { return mWatchChange.any(); }
+
+    // Called by EntityManager for every signature transition.
+    void Record(Entity e, const Signature& before, const Signature& after) {
+        const Signature changed = (before ^ after) & mWatchStructural;
+        if (changed.none()) return;
+        for (unsigned long bits = changed.to_ulong(); bits; bits &= bits - 1) {
+            const int type = std::countr_zero(bits);
+            mTransitions[type].push_back(Transition{ e, after.test(type) });
+        }
+    }
+
+    // now is the current world tick; changes stamped after the previous
+    // dispatch's tick and up to now are reported.
+    void Dispatch(ChangeTick now);
+
+    void ClampTicks(ChangeTick now) { mLastDispatch = ClampTick(mLastDispatch, now); }
+
+private:
+    struct Observer {
+        ObserverId    id;
+        ObserverEvent event;
+        ComponentType type;
+        ObserverFn    fn;
+    };
+
+    // T gained (added) or lost by entity, in the order they happened.
+    struct Transition {
+        Entity entity;
+        bool   added;
+    };
+
+    void Deliver(ObserverEvent event, ComponentType type);
+    void RebuildMasks();
+
+    std::deque<Observer>  mObservers;   // stable while a callback registers more
+    Signature             mWatchAdd;
+    Signature             mWatchRemove;
+    Signature             mWatchChange;
+    Signature             mWatchStructural;    // add or remove watched
+    std::array<std::vector<Transition>, MAX_COMPONENTS> mTransitions;
+    std::array<ChangeScanFn, MAX_COMPONENTS> mChangeScans;
+    std::vector<Transition> mTaken;
+    std::vector<Entity>   mBatch;
+    std::vector<Entity>   mAddBatch;
+    ChangeTick            mLastDispatch = 0;
+    ObserverId            mNextId = 1;
+};
@@ -0,0 +1,52 @@
+#include "Query.h"
+#include "EntityManager.h"
+
+Query::Query(Signature required, Signature excluded, Signature optional)
+    : mRequired(required)
+    , mExcluded(excluded)
+    , mOptional(optional)
+{
+}
+
+const EntitySet& Query::Update(const EntityManager& entities) {
+    const std::uint64_t epoch = entities.StructuralEpoch();
+    if (!mBuilt) {
+        Rebuild(entities);
+    }
+    else if (epoch != mSeenEpoch && Relevant(entities)) {
+        const bool repaired = entities.ChangesSince(mSeenEpoch, [&](Entity e) { Retest(entities, e); });
+        if (repaired) ++mRepairs;
+        else Rebuild(entities);
+    }
+    mSeenEpoch = epoch;
+    return mEntities;
+}
+
+bool Query::Relevant(const EntityManager& entities) const {
+    // With nothing required, creating or destroying any entity matters.
+    if (mRequired.none()) return true;
+
+    const Signature watched = mRequired | mExcluded;
+    for (std::size_t type = 0; type < watched.size(); ++type) {
+        if (watched.test(type) && entities.TypeEpoch(static_cast<ComponentType>(type)) > mSeenEpoch) return true;
+    }
+    return false;
+}
+
+void Query::Rebuild(const EntityManager& entities) {
+    mEntities.Clear();
+
+    const auto& slots = entities.Slots();
+    const auto& signatures = entities.Signatures();
+    for (std::uint32_t slot = 0; slot < slots.size(); ++slot) {
+        // Free slots hold the next free index instead of their own.
+        if (EntityIndex(slots[slot]) == slot && Matches(signatures[slot])) mEntities.Insert(slots[slot]);
+    }
+    mBuilt = true;
+    ++mRebuilds;
+}
+
+void Query::Retest(const EntityManager& entities, Entity e) {
+    if (entities.IsAlive(e) && Matches(entities.Signatures()[EntityIndex(e)])) mEntities.Insert(e);
+    else mEntities.Erase(e);
+}
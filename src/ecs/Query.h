@@ -0,0 +1,54 @@
+#pragma once
+
+#include "ComponentTypes.h"
+#include "EntitySet.h"
+
+#include <cstddef>
+#include <cstdint>
+
+class EntityManager;
+
+// Cached list of the entities whose signature has every required type and
+// none of the excluded ones. Optional types don't affect matching; they
+// tell ECS::Each which components to hand over when present.
+//
+// Update() is free when the structural epoch hasn't moved or no change
+// since the last call touched a required or excluded type. Otherwise the
+// entities in EntityManager's change log are re-tested one by one, and
+// only if the log has wrapped is the whole slot table rescanned.
+class Query {
+public:
+    explicit Query(Signature required, Signature excluded = {}, Signature optional = {});
+
+    bool Matches(const Signature& signature) const {
+        return (signature & mRequired) == mRequired && (signature & mExcluded).none();
+    }
+
+    const EntitySet& Update(const EntityManager& entities);
+
+    // Last result of Update(); may be stale.
+    const EntitySet& Cached() const { return mEntities; }
+
+    const Signature& Required() const { return mRequired; }
+    const Signature& Excluded() const { return mExcluded; }
+    const Signature& Optional() const { return mOptional; }
+
+    // How the cache has been brought up to date so far, for diagnostics.
+    std::uint64_t RebuildCount() const { return mRebuilds; }
+    std::uint64_t RepairCount() const { return mRepairs; }
+
+private:
+    bool Relevant(const EntityManager& entities) const;
+    void Rebuild(const EntityManager& entities);
+    void Retest(const EntityManager& entities, Entity e);
+
+    Signature     mRequired;
+    Signature     mExcluded;
+    Signature     mOptional;
+    EntitySet     mEntities;
+    std::uint64_t mSeenEpoch = 0;
+    bool          mBuilt = false;
+
+    std::uint64_t mRebuilds = 0;
+    std::uint64_t mRepairs = 0;
+};
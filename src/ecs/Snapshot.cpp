@@ -0,0 +1,41 @@
+#include "Snapshot.h"
+#include "ECS.h"
+
+SnapshotPublisher::SnapshotPublisher(ECS& ecs)
+    : mECS(ecs)
+{
+}
+
+void SnapshotPublisher::Publish() {
+    // Nothing tracked: no snapshot to build and no reason to move the clock.
+    if (mTracked.empty()) return;
+
+    ComponentManager& components = mECS.GetComponentManager();
+    // Only this thread replaces mLatest, so reading it unlocked is fine.
+    const Snapshot* previous = mLatest.get();
+
+    auto snapshot = std::make_shared<Snapshot>();
+    snapshot->mSequence = ++mSequence;
+    snapshot->mTick = components.CurrentTick();
+
+    mChunksCopied = 0;
+    mChunksShared = 0;
+    for (const Tracked& tracked : mTracked) {
+        const void* old = previous && tracked.id < previous->mPools.size()
+            ? previous->mPools[tracked.id].get() : nullptr;
+        if (tracked.id >= snapshot->mPools.size()) snapshot->mPools.resize(tracked.id + 1);
+        snapshot->mPools[tracked.id] = tracked.build(components, old, mPublishedTick, mChunksCopied, mChunksShared);
+    }
+
+    // Anything stamped from here on is newer than this snapshot.
+    mPublishedTick = components.CurrentTick();
+    components.AdvanceTick();
+
+    std::lock_guard<std::mutex> lock(mLatestMutex);
+    mLatest = std::move(snapshot);
+}
+
+std::shared_ptr<const Snapshot> SnapshotPublisher::Latest() const {
+    std::lock_guard<std::mutex> lock(mLatestMutex);
+    return mLatest;
+}
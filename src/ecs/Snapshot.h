@@ -0,0 +1,179 @@
+#pragma once
+
+#include "ComponentManager.h"
+#include "Entity.h"
+#include "TypeId.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+class ECS;
+
+// One tracked pool as it was at publish time, in the pool's packed order,
+// split into fixed-size chunks. Chunks that didn't change between two
+// publishes are the same object in both snapshots.
+template<typename T>
+class SnapshotPool {
+public:
+    static constexpr std::size_t CHUNK_SIZE = 256;
+
+    struct Chunk {
+        std::vector<Entity> entities;
+        std::vector<T>      data;
+    };
+
+    // fn(Entity, const T&) for every entity that had T.
+    template<typename Fn>
+    void Each(Fn&& fn) const {
+        for (const auto& chunk : mChunks) {
+            const std::size_t n = chunk->entities.size();
+            for (std::size_t i = 0; i < n; ++i) fn(chunk->entities[i], chunk->data[i]);
+        }
+    }
+
+    std::size_t Size() const { return mSize; }
+    std::size_t ChunkCount() const { return mChunks.size(); }
+    const Chunk& GetChunk(std::size_t index) const { return *mChunks[index]; }
+
+private:
+    friend class SnapshotPublisher;
+
+    std::vector<std::shared_ptr<const Chunk>> mChunks;
+    std::size_t                               mSize = 0;
+};
+
+// Immutable copy of the tracked pools taken by SnapshotPublisher::Publish().
+// Safe to read from any thread for as long as the shared_ptr is held.
+class Snapshot {
+public:
+    // Null if T isn't tracked.
+    template<typename T>
+    const SnapshotPool<T>* Pool() const {
+        const std::size_t id = ComponentTypeId<T>();
+        return id < mPools.size() ? static_cast<const SnapshotPool<T>*>(mPools[id].get()) : nullptr;
+    }
+
+    // 1 for the first publish, then one more per publish.
+    std::uint64_t Sequence() const { return mSequence; }
+
+    // World tick the snapshot was taken at.
+    ChangeTick Tick() const { return mTick; }
+
+private:
+    friend class SnapshotPublisher;
+
+    std::vector<std::shared_ptr<const void>> mPools;
+    std::uint64_t                            mSequence = 0;
+    ChangeTick                               mTick = 0;
+};
+
+// Publishes copy-on-write snapshots of selected component pools so that a
+// consumer (render upload, path tracer) can read frame N while simulation
+// writes frame N+1.
+//
+// Publish() runs on the main thread while no system is running, normally
+// right after ECS::Update. A chunk is copied only if an entity in it was
+// stamped changed since the previous publish or the entities in it moved;
+// otherwise the previous snapshot's chunk is shared. Writes that skip
+// change stamping (GetComponent without MarkChanged) are not picked up
+// until something else dirties the chunk, the same contract as
+// ComponentView::Changed.
+class SnapshotPublisher {
+public:
+    explicit SnapshotPublisher(ECS& ecs);
+
+    // T must be a dense or sparse-paged pool (not a tag or shared type) and
+    // copy-constructible.
+    template<typename T>
+    void Track() {
+        static_assert(std::is_copy_constructible_v<T>, "Snapshot components must be copyable.");
+        const std::size_t id = ComponentTypeId<T>();
+        for (const Tracked& tracked : mTracked) {
+            if (tracked.id == id) return;
+        }
+        mTracked.push_back(Tracked{ id, &BuildPool<T> });
+    }
+
+    // Does nothing until some type is tracked.
+    void Publish();
+
+    // Most recent snapshot, or null before the first Publish().
+    std::shared_ptr<const Snapshot> Latest() const;
+
+    // Chunk reuse of the last Publish(), for diagnostics.
+    std::size_t ChunksCopied() const { return mChunksCopied; }
+    std::size_t ChunksShared() const { return mChunksShared; }
+
+private:
+    using BuildFn = std::shared_ptr<const void>(*)(ComponentManager&, const void* previous,
+        ChangeTick since, std::size_t& copied, std::size_t& shared);
+
+    struct Tracked {
+        std::size_t id;
+        BuildFn     build;
+    };
+
+    template<typename T>
+    static std::shared_ptr<const void> BuildPool(ComponentManager& components, const void* previous,
+        ChangeTick since, std::size_t& copied, std::size_t& shared)
+    {
+        using Pool = SnapshotPool<T>;
+        using Chunk = typename Pool::Chunk;
+        constexpr std::size_t CHUNK = Pool::CHUNK_SIZE;
+
+        ComponentArray<T>* source = components.GetComponentArray<T>();
+        assert(!source->IsTag() && "Tag components can't be snapshotted.");
+
+        const std::size_t size = source->Size();
+        const Entity* entities = source->Entities();
+        const T* data = source->Data();
+        const ChangeTick* ticks = source->ChangedTicks();
+        const Pool* old = static_cast<const Pool*>(previous);
+
+        auto pool = std::make_shared<Pool>();
+        pool->mSize = size;
+        pool->mChunks.reserve((size + CHUNK - 1) / CHUNK);
+
+        for (std::size_t begin = 0; begin < size; begin += CHUNK) {
+            const std::size_t n = std::min(CHUNK, size - begin);
+            const std::size_t index = begin / CHUNK;
+
+            if (old && index < old->mChunks.size()) {
+                const std::shared_ptr<const Chunk>& prior = old->mChunks[index];
+                bool reuse = prior->entities.size() == n
+                    && std::memcmp(prior->entities.data(), entities + begin, n * sizeof(Entity)) == 0;
+                for (std::size_t i = begin; reuse && i < begin + n; ++i) {
+                    reuse = !TickNewer(ticks[i], since);
+                }
+                if (reuse) {
+                    pool->mChunks.push_back(prior);
+                    ++shared;
+                    continue;
+                }
+            }
+
+            auto chunk = std::make_shared<Chunk>();
+            chunk->entities.assign(entities + begin, entities + begin + n);
+            chunk->data.assign(data + begin, data + begin + n);
+            pool->mChunks.push_back(std::move(chunk));
+            ++copied;
+        }
+        return pool;
+    }
+
+    ECS&                            mECS;
+    std::vector<Tracked>            mTracked;
+    std::shared_ptr<const Snapshot> mLatest;
+    mutable std::mutex              mLatestMutex;
+    ChangeTick                      mPublishedTick = 0;
+    std::uint64_t                   mSequence = 0;
+    std::size_t                     mChunksCopied = 0;
+    std::size_t                     mChunksShared = 0;
+};
@@ -1,41 +1,253 @@
 #include "SystemManager.h"
+#include "Chrono.h"
+#include "JobSystem.h"
+#include "Trace.h"
+
 #include <algorithm>
+#include <cmath>
 
-void SystemManager::EntityDestroyed(Entity e) {
-    for (auto& [ti, system] : mSystems) {
-        auto& vec = system->mEntities;
-        vec.erase(std::remove(vec.begin(), vec.end(), e), vec.end());
+void SystemManager::EntityDestroyed(Entity e, const Signature& entitySignature) {
+    // Only systems sharing a component with the entity can contain it.
+    for (std::size_t t = 0; t < MAX_COMPONENTS; ++t) {
+        if (!entitySignature.test(t)) continue;
+        for (const SystemMatch& match : mSystemsByComponent[t]) {
+            match.system->mEntities.Erase(e);
+        }
+    }
+    for (ISystem* system : mMatchAll) {
+        system->mEntities.Erase(e);
     }
 }
 
-void SystemManager::EntitySignatureChanged(Entity e, const Signature& entitySignature) {
-    for (auto& [ti, system] : mSystems) {
-        const auto sigIt = mSignatures.find(ti);
-        if (sigIt == mSignatures.end()) {
-            continue;
+void SystemManager::EntitiesDestroyed(const Entity* entities, std::size_t count, const Signature* signatures) {
+    Signature any;
+    for (std::size_t i = 0; i < count; ++i) any |= signatures[i];
+
+    std::vector<const SystemMatch*> affected;
+    for (std::size_t t = 0; t < MAX_COMPONENTS; ++t) {
+        if (!any.test(t)) continue;
+        for (const SystemMatch& match : mSystemsByComponent[t]) {
+            const bool seen = std::any_of(affected.begin(), affected.end(),
+                [&match](const SystemMatch* other) { return other->system == match.system; });
+            if (!seen) affected.push_back(&match);
         }
+    }
 
-        const Signature& systemSignature = sigIt->second;
-        const bool matches = (entitySignature & systemSignature) == systemSignature;
+    for (const SystemMatch* match : affected) {
+        for (std::size_t i = 0; i < count; ++i) {
+            if ((signatures[i] & match->signature).any()) match->system->mEntities.Erase(entities[i]);
+        }
+    }
+    for (ISystem* system : mMatchAll) {
+        for (std::size_t i = 0; i < count; ++i) system->mEntities.Erase(entities[i]);
+    }
+}
+
+void SystemManager::EntitySignatureChanged(Entity e, const Signature& oldSignature, const Signature& newSignature) {
+    // Membership can only change for systems that care about a flipped bit.
+    const Signature changed = oldSignature ^ newSignature;
+
+    for (std::size_t t = 0; t < MAX_COMPONENTS; ++t) {
+        if (!changed.test(t)) continue;
+        for (const SystemMatch& match : mSystemsByComponent[t]) {
+            if ((newSignature & match.signature) == match.signature) {
+                match.system->mEntities.Insert(e);
+            }
+            else {
+                match.system->mEntities.Erase(e);
+            }
+        }
+    }
+    for (ISystem* system : mMatchAll) {
+        system->mEntities.Insert(e);
+    }
+}
 
-        auto& vec = system->mEntities;
-        auto it = std::find(vec.begin(), vec.end(), e);
+void SystemManager::EntitiesCreated(const Entity* entities, std::size_t count, const Signature& signature) {
+    if (signature.none()) return;
 
-        if (matches) {
-            if (it == vec.end()) vec.push_back(e);
+    std::vector<ISystem*> matched(mMatchAll.begin(), mMatchAll.end());
+    for (std::size_t t = 0; t < MAX_COMPONENTS; ++t) {
+        if (!signature.test(t)) continue;
+        for (const SystemMatch& match : mSystemsByComponent[t]) {
+            if ((signature & match.signature) != match.signature) continue;
+            if (std::find(matched.begin(), matched.end(), match.system) == matched.end()) {
+                matched.push_back(match.system);
+            }
         }
-        else {
-            if (it != vec.end()) vec.erase(it);
+    }
+
+    for (ISystem* system : matched) {
+        system->mEntities.Reserve(system->mEntities.Size() + count);
+        for (std::size_t i = 0; i < count; ++i) {
+            system->mEntities.Insert(entities[i]);
         }
     }
 }
 
 void SystemManager::UpdateAll(float dt) {
-    // Deterministic update: respect registration order
-    for (const auto& ti : mUpdateOrder) {
-        auto it = mSystems.find(ti);
-        if (it != mSystems.end() && it->second) {
-            it->second->Update(dt);
+    if (mScheduleDirty) RebuildSchedule();
+    ++mFrame;
+
+    for (std::size_t order = 0; order < mUpdateOrder.size(); ++order) {
+        UpdateDue(order, mSystems[mUpdateOrder[order]], dt);
+    }
+
+    for (const auto& wave : mWaves) {
+        // Systems sharing a wave never write what the others read, so one
+        // tick per wave is enough to tell their changes from earlier ones.
+        if (mClock) *mClock = NextTick(*mClock);
+        RunWave(wave);
+        if (mClock) *mClock = NextTick(*mClock);
+        if (mSyncPoint) mSyncPoint();
+    }
+}
+
+void SystemManager::UpdateDue(std::size_t order, SystemRecord& record, float dt) {
+    const SystemSchedule& schedule = record.schedule;
+    switch (schedule.mode) {
+    case ScheduleMode::EveryFrame:
+        record.due = true;
+        record.runDt = dt;
+        break;
+    case ScheduleMode::TimeSliced:
+        record.due = true;
+        record.runDt = dt;
+        record.sliceClock += dt;
+        break;
+    case ScheduleMode::EveryNFrames:
+        record.pendingDt += dt;
+        record.due = (mFrame + order) % schedule.frames == 0;
+        if (record.due) {
+            record.runDt = record.pendingDt;
+            record.pendingDt = 0.0f;
+        }
+        break;
+    case ScheduleMode::FixedHz: {
+        const double period = 1.0 / schedule.hz;
+        record.accumulator += dt;
+        record.due = record.accumulator >= period;
+        if (record.due) {
+            record.runDt = static_cast<float>(period);
+            record.accumulator = std::fmod(record.accumulator - period, period);
+        }
+        break;
+    }
+    }
+}
+
+std::size_t SystemManager::WaveCount() {
+    if (mScheduleDirty) RebuildSchedule();
+    return mWaves.size();
+}
+
+void SystemManager::RebuildSchedule() {
+    // A system's wave is one past the latest earlier system it conflicts
+    // with, so registration order is kept wherever it matters.
+    mWaves.clear();
+    std::vector<std::size_t> level(mUpdateOrder.size(), 0);
+
+    for (std::size_t i = 0; i < mUpdateOrder.size(); ++i) {
+        for (std::size_t j = 0; j < i; ++j) {
+            if (level[j] + 1 > level[i] && Conflicts(mUpdateOrder[i], mUpdateOrder[j])) {
+                level[i] = level[j] + 1;
+            }
+        }
+        if (level[i] >= mWaves.size()) mWaves.resize(level[i] + 1);
+        mWaves[level[i]].push_back(mUpdateOrder[i]);
+    }
+    mScheduleDirty = false;
+}
+
+bool SystemManager::Conflicts(std::size_t a, std::size_t b) const {
+    const SystemRecord& ra = mSystems[a];
+    const SystemRecord& rb = mSystems[b];
+    if (!ra.hasAccess || !rb.hasAccess) return true;
+    return ra.access.ConflictsWith(rb.access);
+}
+
+void SystemManager::RunWave(const std::vector<std::size_t>& wave) {
+    const std::size_t due = static_cast<std::size_t>(std::count_if(wave.begin(), wave.end(),
+        [this](std::size_t id) { return mSystems[id].due; }));
+    if (due == 0) return;
+
+    if (due == 1 || !mParallel || jobs::WorkerCount() == 0) {
+        for (const std::size_t id : wave) {
+            if (mSystems[id].due) RunSystem(id);
+        }
+        return;
+    }
+
+    jobs::Counter counter;
+    for (const std::size_t id : wave) {
+        if (!mSystems[id].due || mSystems[id].access.mainThread) continue;
+        jobs::Run([this, id] { RunSystem(id); }, &counter);
+    }
+    for (const std::size_t id : wave) {
+        if (mSystems[id].due && mSystems[id].access.mainThread) RunSystem(id);
+    }
+    jobs::WaitFor(counter);
+}
+
+void SystemManager::RunSystem(std::size_t id) {
+    SystemRecord& record = mSystems[id];
+    diag::ScopedCpuZone zone(record.name, __FILE__, __LINE__);
+    record.system->mLastRunTick = record.runTick;
+    record.runTick = mClock ? *mClock : 0;
+    record.lastEntities = record.system->mEntities.Size();
+    const std::int64_t start = diag::now_ns();
+    if (record.schedule.mode == ScheduleMode::TimeSliced) RunSlices(record);
+    else record.system->Update(record.runDt);
+    record.lastNs = diag::now_ns() - start;
+    record.lastRunFrame = mFrame;
+}
+
+void SystemManager::RunSlices(SystemRecord& record) {
+    // Small enough that the budget is overshot by little, large enough that
+    // the clock reads don't dominate.
+    constexpr std::size_t SLICE_CHUNK = 64;
+
+    ISystem& system = *record.system;
+    const std::int64_t deadline = diag::now_ns() + record.schedule.budgetUs * 1000;
+    // At most one full pass per frame. The set is re-read every chunk in
+    // case the system shrank it (e.g. a main-thread system destroying).
+    for (std::size_t visited = 0; visited < system.mEntities.Size();) {
+        const std::size_t size = system.mEntities.Size();
+        if (record.sliceCursor >= size) record.sliceCursor = 0;
+        const std::size_t count = std::min({ SLICE_CHUNK, size - record.sliceCursor, size - visited });
+
+        // Positions new to the set count as last updated a frame ago. A
+        // chunk goes by its first position: entries only drift between
+        // positions when the set changes.
+        if (record.sliceLastRun.size() != size) {
+            record.sliceLastRun.resize(size, record.sliceClock - record.runDt);
+        }
+        double& lastRun = record.sliceLastRun[record.sliceCursor];
+        const float sliceDt = static_cast<float>(record.sliceClock - lastRun);
+        system.UpdateSlice(sliceDt, system.mEntities.Data() + record.sliceCursor, count);
+        std::fill_n(&lastRun, count, record.sliceClock);
+        record.sliceCursor += count;
+        visited += count;
+        if (diag::now_ns() >= deadline) break;
+    }
+}
+
+void SystemManager::RebuildMatchTable() {
+    for (auto& list : mSystemsByComponent) list.clear();
+    mMatchAll.clear();
+
+    for (const std::size_t id : mUpdateOrder) {
+        const SystemRecord& record = mSystems[id];
+        if (!record.hasSignature) continue;
+
+        if (record.signature.none()) {
+            mMatchAll.push_back(record.system.get());
+            continue;
+        }
+        for (std::size_t t = 0; t < MAX_COMPONENTS; ++t) {
+            if (record.signature.test(t)) {
+                mSystemsByComponent[t].push_back(SystemMatch{ record.system.get(), record.signature });
+            }
         }
     }
 }
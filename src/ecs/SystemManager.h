@@ -3,51 +3,266 @@
 #include "ISystem.h"
 #include "ComponentTypes.h"
 #include "Entity.h"
+#include "TypeId.h"
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
 #include <memory>
-#include <unordered_map>
 #include <vector>
-#include <typeindex>
 #include <cassert>
 
+// What a system touches, used to decide which systems may run at the same
+// time. A system with no declared access conflicts with everything.
+struct SystemAccess {
+    Signature                reads;
+    Signature                writes;
+    std::vector<std::size_t> readResources;     // ResourceTypeId<T>()
+    std::vector<std::size_t> writeResources;
+    bool                     mainThread = false; // GL, ImGui, SDL...
+
+    template<typename T>
+    SystemAccess& ReadResource() {
+        readResources.push_back(ResourceTypeId<T>());
+        return *this;
+    }
+
+    template<typename T>
+    SystemAccess& WriteResource() {
+        writeResources.push_back(ResourceTypeId<T>());
+        return *this;
+    }
+
+    bool ConflictsWith(const SystemAccess& other) const {
+        if ((writes & (other.reads | other.writes)).any()) return true;
+        if ((other.writes & reads).any()) return true;
+        return Overlaps(writeResources, other.readResources)
+            || Overlaps(writeResources, other.writeResources)
+            || Overlaps(readResources, other.writeResources);
+    }
+
+private:
+    static bool Overlaps(const std::vector<std::size_t>& a, const std::vector<std::size_t>& b) {
+        for (const std::size_t id : a) {
+            if (std::find(b.begin(), b.end(), id) != b.end()) return true;
+        }
+        return false;
+    }
+};
+
+// How often a system runs (SystemManager::SetSchedule).
+//   EveryFrame    Update(dt) each frame.
+//   EveryNFrames  Update() on one frame in n, with the dt accumulated since
+//                 the previous run. Systems sharing an n are staggered by
+//                 registration order, so they don't all land on one frame.
+//   FixedHz       Update(1 / hz) whenever a period has elapsed, at most
+//                 once per frame; a backlog beyond one period is dropped.
+//   TimeSliced    UpdateSlice() over a rotating window of mEntities each
+//                 frame, until budgetUs is spent or every entity was seen.
+//                 Each slice is handed the time since its entities were
+//                 last updated: about K * dt when a pass takes K frames.
+enum class ScheduleMode : std::uint8_t { EveryFrame, EveryNFrames, FixedHz, TimeSliced };
+
+struct SystemSchedule {
+    ScheduleMode  mode = ScheduleMode::EveryFrame;
+    std::uint32_t frames = 1;      // EveryNFrames
+    double        hz = 0.0;        // FixedHz
+    std::int64_t  budgetUs = 0;    // TimeSliced
+
+    static SystemSchedule EveryFrame() { return {}; }
+    static SystemSchedule EveryNFrames(std::uint32_t n) {
+        assert(n > 0);
+        return SystemSchedule{ ScheduleMode::EveryNFrames, n, 0.0, 0 };
+    }
+    static SystemSchedule FixedHz(double hz) {
+        assert(hz > 0.0);
+        return SystemSchedule{ ScheduleMode::FixedHz, 1, hz, 0 };
+    }
+    static SystemSchedule TimeSliced(std::int64_t budgetUs) {
+        assert(budgetUs > 0);
+        return SystemSchedule{ ScheduleMode::TimeSliced, 1, 0.0, budgetUs };
+    }
+};
+
+// One system's most recent run, for profiling (see SystemManager::EachTiming).
+struct SystemTiming {
+    const char* name;
+    double      ms;
+    std::size_t entities;   // size of the system's entity set when it ran
+    double      budgetMs;   // 0 when no budget is set
+};
+
 class SystemManager {
 public:
     SystemManager() = default;
 
     template<typename T, typename... Args>
     std::shared_ptr<T> RegisterSystem(Args&&... args) {
-        const std::type_index ti{ typeid(T) };
-        assert(mSystems.find(ti) == mSystems.end() && "Registering system more than once.");
+        const std::size_t id = SystemTypeId<T>();
+        if (id >= mSystems.size()) {
+            mSystems.resize(id + 1);
+        }
+        assert(!mSystems[id].system && "Registering system more than once.");
         auto system = std::make_shared<T>(std::forward<Args>(args)...);
-        mSystems.emplace(ti, system);
+        mSystems[id].system = system;
+        mSystems[id].name = TypeName<T>();
 
         // Record deterministic update order: order of registration
-        mUpdateOrder.push_back(ti);
+        mUpdateOrder.push_back(id);
+        mScheduleDirty = true;
 
         return system;
     }
 
     template<typename T>
     std::shared_ptr<T> GetSystem() {
-        const std::type_index ti{ typeid(T) };
-        auto it = mSystems.find(ti);
-        assert(it != mSystems.end() && "System used before registered.");
-        return std::static_pointer_cast<T>(it->second);
+        return std::static_pointer_cast<T>(Record<T>().system);
     }
 
     template<typename T>
     void SetSignature(const Signature& signature) {
-        const std::type_index ti{ typeid(T) };
-        assert(mSystems.find(ti) != mSystems.end() && "System used before registered.");
-        mSignatures[ti] = signature;
+        SystemRecord& record = Record<T>();
+        record.signature = signature;
+        record.hasSignature = true;
+        RebuildMatchTable();
+    }
+
+    // Systems that declare access can share a wave with non-conflicting
+    // ones; conflicting systems keep their registration order.
+    template<typename T>
+    void SetAccess(const SystemAccess& access) {
+        SystemRecord& record = Record<T>();
+        record.access = access;
+        record.hasAccess = true;
+        mScheduleDirty = true;
     }
 
-    void EntityDestroyed(Entity e);
-    void EntitySignatureChanged(Entity e, const Signature& entitySignature);
+    template<typename T>
+    void SetSchedule(const SystemSchedule& schedule) {
+        SystemRecord& record = Record<T>();
+        record.schedule = schedule;
+        record.pendingDt = 0.0f;
+        record.accumulator = 0.0;
+        record.sliceCursor = 0;
+        record.sliceClock = 0.0;
+        record.sliceLastRun.clear();
+    }
+
+    // Frame-time budget for a system; runs over it are flagged by the
+    // diagnostics overlay. 0 removes the budget.
+    template<typename T>
+    void SetBudget(double ms) {
+        Record<T>().budgetMs = ms;
+    }
+
+    // fn(const SystemTiming&) for every system the last UpdateAll ran, in
+    // registration order.
+    template<typename Fn>
+    void EachTiming(Fn&& fn) const {
+        if (mFrame == 0) return;
+        for (const std::size_t id : mUpdateOrder) {
+            const SystemRecord& record = mSystems[id];
+            if (record.lastRunFrame != mFrame) continue;
+            fn(SystemTiming{ record.name, double(record.lastNs) / 1'000'000.0, record.lastEntities, record.budgetMs });
+        }
+    }
+
+    // Heap bytes of every system's entity set.
+    std::size_t MembershipBytes() const {
+        std::size_t bytes = 0;
+        for (const std::size_t id : mUpdateOrder) bytes += mSystems[id].system->mEntities.BytesReserved();
+        return bytes;
+    }
+
+    // Batch form of EntitySignatureChanged for entities created with
+    // signature: matching systems are resolved once for the whole batch.
+    void EntitiesCreated(const Entity* entities, std::size_t count, const Signature& signature);
+
+    // entitySignature is the signature the entity had when it was destroyed.
+    void EntityDestroyed(Entity e, const Signature& entitySignature);
+    // Batch form of EntityDestroyed: each affected system is visited once.
+    void EntitiesDestroyed(const Entity* entities, std::size_t count, const Signature* signatures);
+    void EntitySignatureChanged(Entity e, const Signature& oldSignature, const Signature& newSignature);
+    // Runs the schedule wave by wave. Systems within a wave run on the job
+    // system unless parallel update is off or there are no workers.
     void UpdateAll(float dt);
 
+    void        SetParallelUpdate(bool enabled) { mParallel = enabled; }
+    std::size_t WaveCount();
+
+    // World change clock, advanced before each wave and before each sync
+    // point so every system run and every flush gets a tick of its own.
+    void SetClock(ChangeTick* clock) { mClock = clock; }
+
+    // Clamps the run ticks systems filter changes with; see ChangeTick.
+    void ClampTicks(ChangeTick now) {
+        for (SystemRecord& record : mSystems) {
+            record.runTick = ClampTick(record.runTick, now);
+            if (record.system) record.system->mLastRunTick = ClampTick(record.system->mLastRunTick, now);
+        }
+    }
+
+    // Invoked after every wave; the ECS flushes deferred commands here.
+    void SetSyncPointCallback(std::function<void()> callback) { mSyncPoint = std::move(callback); }
+
 private:
-    std::unordered_map<std::type_index, Signature>                mSignatures;
-    std::unordered_map<std::type_index, std::shared_ptr<ISystem>> mSystems;
-    std::vector<std::type_index>                                  mUpdateOrder;
+    struct SystemRecord {
+        std::shared_ptr<ISystem> system;
+        Signature                signature;
+        bool                     hasSignature = false;
+        SystemAccess             access;
+        bool                     hasAccess = false;
+        const char*              name = nullptr;
+        ChangeTick               runTick = 0;
+        double                   budgetMs = 0.0;
+        std::int64_t             lastNs = 0;
+        std::size_t              lastEntities = 0;
+        std::uint64_t            lastRunFrame = 0;
+        SystemSchedule           schedule;
+        bool                     due = true;        // runs this UpdateAll
+        float                    runDt = 0.0f;      // dt it is handed
+        float                    pendingDt = 0.0f;  // EveryNFrames
+        double                   accumulator = 0.0; // FixedHz
+        std::size_t              sliceCursor = 0;   // TimeSliced
+        double                   sliceClock = 0.0;  // TimeSliced: sum of dt
+        std::vector<double>      sliceLastRun;      // sliceClock per position when last updated
+    };
+
+    template<typename T>
+    SystemRecord& Record() {
+        const std::size_t id = SystemTypeId<T>();
+        assert(id < mSystems.size() && mSystems[id].system && "System used before registered.");
+        return mSystems[id];
+    }
+
+    void RebuildMatchTable();
+    void RebuildSchedule();
+    bool Conflicts(std::size_t a, std::size_t b) const;
+    void RunWave(const std::vector<std::size_t>& wave);
+    void RunSystem(std::size_t id);
+    void RunSlices(SystemRecord& record);
+    void UpdateDue(std::size_t order, SystemRecord& record, float dt);
+
+    // Indexed by SystemTypeId<T>(); mUpdateOrder holds registered ids.
+    std::vector<SystemRecord> mSystems;
+    std::vector<std::size_t>  mUpdateOrder;
+
+    // Signature-match table: systems whose signature contains each component
+    // bit, plus systems with an empty signature (they match every entity).
+    struct SystemMatch {
+        ISystem*  system;
+        Signature signature;
+    };
+    std::array<std::vector<SystemMatch>, MAX_COMPONENTS> mSystemsByComponent;
+    std::vector<ISystem*>                                mMatchAll;
+
+    // Topological levels of the conflict DAG, each in registration order.
+    std::vector<std::vector<std::size_t>> mWaves;
+    bool                                  mScheduleDirty = false;
+    bool                                  mParallel = true;
+
+    ChangeTick*           mClock = nullptr;
+    std::function<void()> mSyncPoint;
+    std::uint64_t         mFrame = 0;       // UpdateAll calls, for EachTiming
 };
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <typeinfo>
+
+#if defined(__GNUC__)
+#include <cstdlib>
+#include <cxxabi.h>
+#endif
+
+// Dense per-family type ids, assigned the first time a type is asked for.
+// Each family has its own counter, so ids stay small and can index flat
+// arrays directly instead of hashing std::type_index.
+template<typename Family>
+class TypeFamily {
+public:
+    template<typename T>
+    static std::size_t Id() {
+        static const std::size_t id = sNext.fetch_add(1, std::memory_order_relaxed);
+        return id;
+    }
+
+    static std::size_t Count() { return sNext.load(std::memory_order_relaxed); }
+
+private:
+    inline static std::atomic<std::size_t> sNext{ 0 };
+};
+
+struct ComponentFamily;
+struct SystemFamily;
+struct ResourceFamily;
+
+inline constexpr std::size_t INVALID_TYPE_ID = std::numeric_limits<std::size_t>::max();
+
+template<typename T>
+std::size_t ComponentTypeId() {
+    return TypeFamily<ComponentFamily>::template Id<std::remove_cv_t<T>>();
+}
+
+template<typename T>
+std::size_t SystemTypeId() {
+    return TypeFamily<SystemFamily>::template Id<std::remove_cv_t<T>>();
+}
+
+// Non-component shared state (a physics world, an asset cache...) that
+// systems declare access to for scheduling.
+template<typename T>
+std::size_t ResourceTypeId() {
+    return TypeFamily<ResourceFamily>::template Id<std::remove_cv_t<T>>();
+}
+
+// Readable name of T for trace zones and diagnostics tables. MSVC spells
+// type names "class Foo", so the prefix is dropped; GCC and Clang give the
+// mangled name, so it is demangled. Computed once per type and kept for the
+// life of the process.
+template<typename T>
+const char* TypeName() {
+    static const char* const name = [] {
+        const char* raw = typeid(T).name();
+#if defined(__GNUC__)
+        int status = 0;
+        if (char* demangled = abi::__cxa_demangle(raw, nullptr, nullptr, &status)) {
+            if (status == 0) return static_cast<const char*>(demangled);
+            std::free(demangled);
+        }
+#endif
+        for (const char* prefix : { "class ", "struct " }) {
+            const std::size_t length = std::strlen(prefix);
+            if (std::strncmp(raw, prefix, length) == 0) return raw + length;
+        }
+        return raw;
+    }();
+    return name;
+}
@@ -0,0 +1,300 @@
+#pragma once
+
+#include "ComponentManager.h"
+#include "Entity.h"
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Typed multi-component view. Pools are resolved once when the view is
+// built; Each() walks the smallest pool's packed arrays and probes the
+// others by sparse index, so iteration does no hashing and no refcounting.
+//
+// Ts may be const-qualified for read-only access. A non-const component is
+// stamped as changed only when fn actually wrote it: trivially copyable
+// types are compared with their bytes from before the call, other types are
+// stamped on every visit. Iterating what you only read as const still saves
+// that comparison. Changed<T>(since) / Added<T>(since) keep entities
+// whose T was stamped after the given tick (usually the system's
+// mLastRunTick). Adding or removing any of the viewed components while
+// iterating is not supported.
+//
+// When Ts are exactly the types of an owning group (ECS::RegisterGroup),
+// iteration walks the group's packed prefix and does no sparse probes.
+//
+// Tag components are probed through the entity's signature and never lead
+// iteration unless every viewed type is a tag, in which case the view
+// scans all entity slots. They cannot be filtered on.
+template<typename... Ts>
+class ComponentView {
+    static_assert(sizeof...(Ts) > 0, "ComponentView needs at least one component type.");
+
+    template<typename T>
+    using PoolFor = ComponentArray<std::remove_const_t<T>>;
+
+public:
+    explicit ComponentView(PoolFor<Ts>*... pools)
+        : mPools{ pools... }
+    {
+    }
+
+    template<typename T>
+    ComponentView Changed(ChangeTick since) const {
+        static_assert(IndexOf<T>() < sizeof...(Ts), "Changed<T> needs T to be one of the viewed components.");
+        assert(!std::get<IndexOf<T>()>(mPools)->IsTag() && "Tag components have no change ticks.");
+        ComponentView view = *this;
+        TickFilter& filter = view.mFilters[IndexOf<T>()];
+        filter.changed = true;
+        filter.changedSince = since;
+        view.mFiltered = true;
+        return view;
+    }
+
+    template<typename T>
+    ComponentView Added(ChangeTick since) const {
+        static_assert(IndexOf<T>() < sizeof...(Ts), "Added<T> needs T to be one of the viewed components.");
+        assert(!std::get<IndexOf<T>()>(mPools)->IsTag() && "Tag components have no change ticks.");
+        ComponentView view = *this;
+        TickFilter& filter = view.mFilters[IndexOf<T>()];
+        filter.added = true;
+        filter.addedSince = since;
+        view.mFiltered = true;
+        return view;
+    }
+
+    // fn(Entity, Ts&...) or fn(Ts&...) for every entity that has all of Ts.
+    template<typename Fn>
+    void Each(Fn&& fn) const {
+        EachDispatch(fn, std::index_sequence_for<Ts...>{});
+    }
+
+    // Each() split into cache-sized batches of the smallest pool and run on
+    // the job system. fn is called concurrently and must only touch the
+    // entity it is given (use jobs::WorkerLocal for scratch).
+    template<typename Fn>
+    void ParallelEach(Fn&& fn) const {
+        const std::size_t lead = PickLead();
+        const std::size_t count = PoolSize(lead);
+        jobs::ParallelFor(count, jobs::AutoGrain(count, BytesPerEntity()), [&](std::size_t begin, std::size_t end) {
+            EachRangeDispatch(fn, lead, begin, end, std::index_sequence_for<Ts...>{});
+        });
+    }
+
+    // fn(R& acc, [Entity,] Ts&...) folded per batch from identity, then the
+    // batch results are combined in order on the calling thread. Batches
+    // depend only on the pool size, so the result is the same for any
+    // number of workers. ParallelFor may hand over several batches at once
+    // (it runs everything inline without workers), so each range is split
+    // back into its batches here.
+    template<typename R, typename Fn, typename Combine>
+    R ParallelReduce(const R& identity, Fn&& fn, Combine&& combine) const {
+        const std::size_t lead = PickLead();
+        const std::size_t count = PoolSize(lead);
+        const std::size_t grain = jobs::FixedGrain(BytesPerEntity());
+
+        std::vector<R> partials((count + grain - 1) / grain, identity);
+        jobs::ParallelFor(count, grain, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t batch = begin; batch < end; batch += grain) {
+                R& acc = partials[batch / grain];
+                auto accumulate = [&acc, &fn](auto&&... args) -> decltype(fn(acc, args...)) {
+                    return fn(acc, args...);
+                };
+                EachRangeDispatch(accumulate, lead, batch, std::min(batch + grain, end), std::index_sequence_for<Ts...>{});
+            }
+        });
+
+        R result = identity;
+        for (const R& partial : partials) combine(result, partial);
+        return result;
+    }
+
+    // Upper bound on the number of matches: the smallest pool's size.
+    std::size_t SizeHint() const {
+        return std::apply([](auto*... pools) {
+            std::size_t n = static_cast<std::size_t>(-1);
+            ((n = pools->Size() < n ? pools->Size() : n), ...);
+            return n;
+        }, mPools);
+    }
+
+private:
+    // Lead value meaning "walk the owning group's packed prefix".
+    static constexpr std::size_t PACKED = sizeof...(Ts);
+
+    template<typename Fn, std::size_t... Is>
+    void EachDispatch(Fn& fn, std::index_sequence<Is...>) const {
+        const std::size_t lead = PickLead();
+        EachRangeDispatch(fn, lead, 0, PoolSize(lead), std::index_sequence<Is...>{});
+    }
+
+    template<typename Fn, std::size_t... Is>
+    void EachRangeDispatch(Fn& fn, std::size_t lead, std::size_t begin, std::size_t end,
+        std::index_sequence<Is...>) const
+    {
+        if (lead == PACKED) {
+            EachPacked(fn, begin, end, std::index_sequence<Is...>{});
+            return;
+        }
+        (void)((lead == Is ? (EachLedBy<Is>(fn, begin, end, std::index_sequence<Is...>{}), true) : false) || ...);
+    }
+
+    // Entries [begin, end) of the group prefix: the same index in every pool.
+    template<typename Fn, std::size_t... Is>
+    void EachPacked(Fn& fn, std::size_t begin, std::size_t end, std::index_sequence<Is...>) const {
+        const Entity* entities = std::get<0>(mPools)->Entities();
+        const std::tuple<std::remove_const_t<Ts>*...> data{ std::get<Is>(mPools)->Data()... };
+
+        for (std::size_t i = begin; i < end; ++i) {
+            Visit<PACKED>(fn, entities[i], std::tuple<std::remove_const_t<Ts>*...>{ std::get<Is>(data) + i... },
+                std::index_sequence<Is...>{});
+        }
+    }
+
+    // Walks entries [begin, end) of the lead pool.
+    template<std::size_t Lead, typename Fn, std::size_t... Is>
+    void EachLedBy(Fn& fn, std::size_t begin, std::size_t end, std::index_sequence<Is...>) const {
+        auto* leadPool = std::get<Lead>(mPools);
+        const Entity* entities = leadPool->Entities();
+        auto* leadData = leadPool->Data();
+
+        for (std::size_t i = begin; i < end; ++i) {
+            const Entity e = entities[i];
+            const std::tuple<std::remove_const_t<Ts>*...> refs{ Fetch<Is, Lead>(e, leadData, i)... };
+            if (!((std::get<Is>(refs) != nullptr) && ...)) continue;
+            Visit<Lead>(fn, e, refs, std::index_sequence<Is...>{});
+        }
+    }
+
+    // What a component looked like before fn ran, to tell whether fn wrote
+    // it. Only non-const, non-empty, trivially copyable components keep a
+    // copy; other non-const ones always count as written, empty ones never.
+    template<typename T, bool Compare = !std::is_const_v<T> && !std::is_empty_v<T> && std::is_trivially_copyable_v<T>>
+    struct WriteProbe {
+        explicit WriteProbe(const void*) {}
+        bool Written(const void*) const { return !std::is_const_v<T> && !std::is_empty_v<T>; }
+    };
+
+    template<typename T>
+    struct WriteProbe<T, true> {
+        explicit WriteProbe(const void* component) { std::memcpy(bytes, component, sizeof(T)); }
+        bool Written(const void* component) const { return std::memcmp(bytes, component, sizeof(T)) != 0; }
+        alignas(T) unsigned char bytes[sizeof(T)];
+    };
+
+    // Filters, calls fn and stamps what it wrote for one matched entity.
+    template<std::size_t Lead, typename Fn, std::size_t... Is>
+    void Visit(Fn& fn, Entity e, const std::tuple<std::remove_const_t<Ts>*...>& refs,
+        std::index_sequence<Is...>) const
+    {
+        if (mFiltered && !(PassesFilter<Is>(std::get<Is>(refs)) && ...)) return;
+
+        const std::tuple<WriteProbe<Ts>...> before{ WriteProbe<Ts>(std::get<Is>(refs))... };
+        if constexpr (std::is_invocable_v<Fn&, Entity, Ts&...>) {
+            fn(e, static_cast<Ts&>(*std::get<Is>(refs))...);
+        }
+        else {
+            fn(static_cast<Ts&>(*std::get<Is>(refs))...);
+        }
+        ((std::get<Is>(before).Written(std::get<Is>(refs)) ? StampChanged<Is>(std::get<Is>(refs)) : void()), ...);
+    }
+
+    template<std::size_t I, typename C>
+    bool PassesFilter(C* component) const {
+        const TickFilter& filter = mFilters[I];
+        if (!filter.changed && !filter.added) return true;
+
+        auto* pool = std::get<I>(mPools);
+        const std::size_t index = static_cast<std::size_t>(component - pool->Data());
+        if (filter.changed && !TickNewer(pool->ChangedTicks()[index], filter.changedSince)) return false;
+        if (filter.added && !TickNewer(pool->AddedTicks()[index], filter.addedSince)) return false;
+        return true;
+    }
+
+    template<std::size_t I, typename C>
+    void StampChanged(C* component) const {
+        if constexpr (!std::is_const_v<std::tuple_element_t<I, std::tuple<Ts...>>>) {
+            auto* pool = std::get<I>(mPools);
+            pool->MarkChangedAt(static_cast<std::size_t>(component - pool->Data()));
+        }
+    }
+
+    template<typename T>
+    static constexpr std::size_t IndexOf() {
+        constexpr bool matches[] = { std::is_same_v<std::remove_const_t<T>, std::remove_const_t<Ts>>... };
+        for (std::size_t i = 0; i < sizeof...(Ts); ++i) {
+            if (matches[i]) return i;
+        }
+        return sizeof...(Ts);
+    }
+
+    template<std::size_t I, std::size_t Lead, typename LeadT>
+    auto* Fetch(Entity e, LeadT* leadData, std::size_t i) const {
+        if constexpr (I == Lead && std::is_empty_v<LeadT>) {
+            // A tag lead walks every slot; keep only the members.
+            auto* pool = std::get<I>(mPools);
+            return pool->IsTag() ? (pool->Has(e) ? leadData : nullptr) : leadData + i;
+        }
+        else if constexpr (I == Lead) {
+            return leadData + i;
+        }
+        else {
+            return std::get<I>(mPools)->TryGetData(e);
+        }
+    }
+
+    std::size_t PoolSize(std::size_t index) const {
+        if (index == PACKED) return std::get<0>(mPools)->Group()->Size();
+        return std::apply([index](auto*... pools) {
+            const std::size_t sizes[] = { pools->Size()... };
+            return sizes[index];
+        }, mPools);
+    }
+
+    static constexpr std::size_t BytesPerEntity() {
+        return sizeof(Entity) + (sizeof(Ts) + ...);
+    }
+
+    // PACKED when Ts are exactly one owning group, else the smallest pool.
+    std::size_t PickLead() const {
+        if (IsOwningGroup()) return PACKED;
+        return SmallestPoolImpl(std::index_sequence_for<Ts...>{});
+    }
+
+    bool IsOwningGroup() const {
+        const GroupBase* group = std::get<0>(mPools)->Group();
+        if (!group || group->OwnedCount() != sizeof...(Ts)) return false;
+        return std::apply([group](auto*... pools) { return ((pools->Group() == group) && ...); }, mPools);
+    }
+
+    template<std::size_t... Is>
+    std::size_t SmallestPoolImpl(std::index_sequence<Is...>) const {
+        // Tags cost a full slot scan to lead, so they rank last.
+        const std::size_t sizes[] = {
+            (std::get<Is>(mPools)->IsTag() ? static_cast<std::size_t>(-1) : std::get<Is>(mPools)->Size())...
+        };
+        std::size_t best = 0;
+        for (std::size_t i = 1; i < sizeof...(Ts); ++i) {
+            if (sizes[i] < sizes[best]) best = i;
+        }
+        return best;
+    }
+
+    struct TickFilter {
+        bool       changed = false;
+        bool       added = false;
+        ChangeTick changedSince = 0;
+        ChangeTick addedSince = 0;
+    };
+
+    std::tuple<PoolFor<Ts>*...>           mPools;
+    std::array<TickFilter, sizeof...(Ts)> mFilters{};
+    bool                                  mFiltered = false;
+};
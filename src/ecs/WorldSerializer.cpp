@@ -0,0 +1,220 @@
+#include "WorldSerializer.h"
+#include "ECS.h"
+#include "MappedFile.h"
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <unordered_map>
+
+namespace {
+    constexpr char MAGIC[4] = { 'A', 'E', 'C', 'W' };
+
+    bool Fail(std::string* error, std::string why) {
+        if (error) *error = std::move(why);
+        return false;
+    }
+}
+
+std::vector<std::byte> WorldSerializer::SaveToMemory(ECS& ecs) const {
+    ComponentManager& components = ecs.GetComponentManager();
+    const EntityManager& entities = ecs.GetEntityManager();
+
+    std::vector<const Entry*> pools;
+    std::vector<ComponentType> types;
+    for (const Entry& entry : mEntries) {
+        if (!entry.registered(components)) continue;
+        pools.push_back(&entry);
+        types.push_back(entry.type(components));
+    }
+
+    const std::vector<Entity>& slots = entities.Slots();
+    const std::vector<Signature>& signatures = entities.Signatures();
+    std::vector<Entity> saved;
+    std::vector<std::uint32_t> masks;
+    saved.reserve(entities.LivingCount());
+    masks.reserve(entities.LivingCount());
+    for (std::uint32_t slot = 0; slot < slots.size(); ++slot) {
+        if (EntityIndex(slots[slot]) != slot) continue;
+        std::uint32_t mask = 0;
+        for (std::size_t i = 0; i < types.size(); ++i) {
+            if (signatures[slot].test(types[i])) mask |= 1u << i;
+        }
+        saved.push_back(slots[slot]);
+        masks.push_back(mask);
+    }
+
+    WorldWriter out;
+    out.WriteBytes(MAGIC, sizeof(MAGIC));
+    out.Write(FORMAT_VERSION);
+    out.Write(static_cast<std::uint32_t>(saved.size()));
+    out.Write(static_cast<std::uint32_t>(pools.size()));
+    out.WriteBytes(saved.data(), saved.size() * sizeof(Entity));
+    out.WriteBytes(masks.data(), masks.size() * sizeof(std::uint32_t));
+
+    for (const Entry* entry : pools) {
+        out.WriteString(entry->name);
+        out.Write(static_cast<std::uint32_t>(entry->kind));
+        out.Write(entry->elementSize);
+
+        // Payload size is patched in once the payload is written.
+        const std::size_t sizeAt = out.Size();
+        out.Write(std::uint64_t(0));
+        entry->save(components, out);
+        const std::uint64_t payload = out.Size() - sizeAt - sizeof(std::uint64_t);
+        std::memcpy(out.mBytes.data() + sizeAt, &payload, sizeof(payload));
+    }
+    return std::move(out.mBytes);
+}
+
+bool WorldSerializer::Save(ECS& ecs, const std::string& path, std::string* error) const {
+    const std::vector<std::byte> bytes = SaveToMemory(ecs);
+    std::ofstream out(path, std::ios::binary);
+    if (!out) return Fail(error, "can't open " + path + " for writing");
+    out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    if (!out) return Fail(error, "write to " + path + " failed");
+    return true;
+}
+
+bool WorldSerializer::Load(ECS& ecs, const std::string& path, std::vector<Entity>* loaded, std::string* error) const {
+    plat::MappedFile file;
+    if (!file.Open(path)) return Fail(error, "can't open " + path);
+    return LoadFromMemory(ecs, file.Data(), file.Size(), loaded, error);
+}
+
+bool WorldSerializer::LoadFromMemory(ECS& ecs, const void* data, std::size_t size,
+    std::vector<Entity>* loaded, std::string* error) const
+{
+    WorldReader in(data, size);
+    const std::byte* magic = in.Take(sizeof(MAGIC));
+    if (!magic || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0) return Fail(error, "not a world file");
+    const std::uint32_t version = in.Read<std::uint32_t>();
+    if (version != FORMAT_VERSION) {
+        return Fail(error, "world format version " + std::to_string(version) + " is not supported");
+    }
+    const std::uint32_t count = in.Read<std::uint32_t>();
+    const std::uint32_t poolCount = in.Read<std::uint32_t>();
+    const std::byte* savedBytes = in.Take(std::size_t(count) * sizeof(Entity));
+    const std::byte* maskBytes = in.Take(std::size_t(count) * sizeof(std::uint32_t));
+    if (!in.Ok() || poolCount > MAX_POOLS) return Fail(error, "world header is corrupt");
+
+    // Resolve every pool before touching the world, so a mismatched file
+    // changes nothing.
+    struct FilePool {
+        const Entry*     entry = nullptr;
+        const std::byte* payload = nullptr;
+        std::size_t      size = 0;
+    };
+    ComponentManager& components = ecs.GetComponentManager();
+    std::array<FilePool, MAX_POOLS> filePools{};
+    std::array<ComponentType, MAX_POOLS> types{};
+    std::uint32_t knownMask = 0;
+
+    for (std::uint32_t i = 0; i < poolCount; ++i) {
+        const std::string_view name = in.ReadString();
+        const auto kind = static_cast<Kind>(in.Read<std::uint32_t>());
+        const std::uint32_t elementSize = in.Read<std::uint32_t>();
+        const std::uint64_t payloadSize = in.Read<std::uint64_t>();
+        const std::byte* payload = in.Take(static_cast<std::size_t>(payloadSize));
+        if (!in.Ok()) return Fail(error, "world file is truncated");
+
+        const Entry* entry = nullptr;
+        for (const Entry& candidate : mEntries) {
+            if (candidate.name == name) entry = &candidate;
+        }
+        if (!entry || !entry->registered(components)) continue;
+        if (entry->kind != kind || entry->elementSize != elementSize) {
+            return Fail(error, "component " + entry->name + " is stored differently than it was saved");
+        }
+        filePools[i] = FilePool{ entry, payload, static_cast<std::size_t>(payloadSize) };
+        types[i] = entry->type(components);
+        knownMask |= 1u << i;
+    }
+
+    EntityRemap remap;
+    remap.mSaved.resize(count);
+    remap.mLoaded.resize(count, INVALID_ENTITY);
+    if (count) std::memcpy(remap.mSaved.data(), savedBytes, std::size_t(count) * sizeof(Entity));
+
+    std::uint32_t slots = 0;
+    for (const Entity e : remap.mSaved) slots = std::max(slots, EntityIndex(e) + 1);
+    remap.mRecordOfSlot.assign(slots, std::numeric_limits<std::uint32_t>::max());
+    for (std::uint32_t record = 0; record < count; ++record) {
+        remap.mRecordOfSlot[EntityIndex(remap.mSaved[record])] = record;
+    }
+
+    // Entities sharing a mask share a signature: create each such batch in
+    // one call, with its final signature already set.
+    struct Batch {
+        Signature                  signature;
+        std::vector<std::uint32_t> records;
+        std::vector<Entity>        created;
+    };
+    std::vector<Batch> batches;
+    std::unordered_map<std::uint32_t, std::size_t> batchOfMask;
+    for (std::uint32_t record = 0; record < count; ++record) {
+        std::uint32_t mask;
+        std::memcpy(&mask, maskBytes + std::size_t(record) * sizeof(mask), sizeof(mask));
+        mask &= knownMask;
+
+        const auto [it, added] = batchOfMask.try_emplace(mask, batches.size());
+        if (added) {
+            Batch& batch = batches.emplace_back();
+            for (std::uint32_t i = 0; i < poolCount; ++i) {
+                if (mask & (1u << i)) batch.signature.set(types[i]);
+            }
+        }
+        batches[it->second].records.push_back(record);
+    }
+
+    EntityManager& entities = ecs.GetEntityManager();
+    for (Batch& batch : batches) {
+        batch.created.resize(batch.records.size());
+        entities.CreateEntities(static_cast<std::uint32_t>(batch.records.size()), batch.created.data(), batch.signature);
+        for (std::size_t k = 0; k < batch.records.size(); ++k) {
+            remap.mLoaded[batch.records[k]] = batch.created[k];
+        }
+    }
+
+    std::vector<std::uint8_t> pending(count);
+    for (std::uint32_t i = 0; i < poolCount; ++i) {
+        const FilePool& pool = filePools[i];
+        if (!pool.entry) continue;
+
+        // Every entity whose mask has this pool must be in its payload once.
+        for (std::uint32_t record = 0; record < count; ++record) {
+            std::uint32_t mask;
+            std::memcpy(&mask, maskBytes + std::size_t(record) * sizeof(mask), sizeof(mask));
+            pending[record] = (mask >> i) & 1u;
+        }
+        WorldReader payload(pool.payload, pool.size);
+        const bool ok = pool.entry->load(components, payload, remap, pending) && payload.Ok()
+            && std::find(pending.begin(), pending.end(), std::uint8_t(1)) == pending.end();
+        if (!ok) {
+            // Take back everything added so far. Systems haven't seen the
+            // new entities yet; pools skip the ones they never received.
+            std::vector<Entity> created;
+            std::vector<Signature> signatures;
+            created.reserve(count);
+            signatures.reserve(count);
+            for (const Batch& batch : batches) {
+                created.insert(created.end(), batch.created.begin(), batch.created.end());
+                signatures.insert(signatures.end(), batch.created.size(), batch.signature);
+            }
+            components.EntitiesDestroyed(created.data(), created.size(), signatures.data());
+            entities.DestroyEntities(created.data(), created.size());
+            return Fail(error, "component " + pool.entry->name + " data is corrupt");
+        }
+    }
+
+    // Systems see each batch once its components are in place.
+    SystemManager& systems = ecs.GetSystemManager();
+    for (const Batch& batch : batches) {
+        systems.EntitiesCreated(batch.created.data(), batch.created.size(), batch.signature);
+    }
+
+    if (loaded) *loaded = std::move(remap.mLoaded);
+    return true;
+}
@@ -0,0 +1,326 @@
+#pragma once
+
+#include "ComponentManager.h"
+#include "Entity.h"
+#include "TypeId.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+class ECS;
+
+// Append-only byte stream handed to registered component serializers.
+class WorldWriter {
+public:
+    void WriteBytes(const void* data, std::size_t size) {
+        const auto* bytes = static_cast<const std::byte*>(data);
+        mBytes.insert(mBytes.end(), bytes, bytes + size);
+    }
+
+    template<typename T>
+    void Write(const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>, "Write() is for plain values; serialize members one by one.");
+        WriteBytes(&value, sizeof(T));
+    }
+
+    void WriteString(std::string_view s) {
+        Write(static_cast<std::uint32_t>(s.size()));
+        WriteBytes(s.data(), s.size());
+    }
+
+    const std::vector<std::byte>& Bytes() const { return mBytes; }
+    std::size_t Size() const { return mBytes.size(); }
+
+private:
+    friend class WorldSerializer;
+
+    std::vector<std::byte> mBytes;
+};
+
+// Bounds-checked reader over a saved world. Reading past the end yields
+// zeroes and clears Ok(); the loader then rejects the file.
+class WorldReader {
+public:
+    WorldReader(const void* data, std::size_t size)
+        : mCursor(static_cast<const std::byte*>(data))
+        , mEnd(static_cast<const std::byte*>(data) + size)
+    {
+    }
+
+    // Pointer to the next size bytes, or null if there aren't that many.
+    const std::byte* Take(std::size_t size) {
+        if (!mOk || static_cast<std::size_t>(mEnd - mCursor) < size) {
+            mOk = false;
+            return nullptr;
+        }
+        const std::byte* at = mCursor;
+        mCursor += size;
+        return at;
+    }
+
+    template<typename T>
+    T Read() {
+        static_assert(std::is_trivially_copyable_v<T>, "Read() is for plain values.");
+        T value{};
+        if (const std::byte* at = Take(sizeof(T))) std::memcpy(&value, at, sizeof(T));
+        return value;
+    }
+
+    std::string_view ReadString() {
+        const std::uint32_t size = Read<std::uint32_t>();
+        const std::byte* at = Take(size);
+        return at ? std::string_view(reinterpret_cast<const char*>(at), size) : std::string_view();
+    }
+
+    bool        Ok() const { return mOk; }
+    std::size_t Remaining() const { return static_cast<std::size_t>(mEnd - mCursor); }
+
+private:
+    const std::byte* mCursor;
+    const std::byte* mEnd;
+    bool             mOk = true;
+};
+
+// Saved handle -> handle in the world being loaded. Handles that weren't in
+// the file (or were INVALID_ENTITY) map to INVALID_ENTITY.
+class EntityRemap {
+public:
+    Entity operator()(Entity saved) const {
+        const std::uint32_t record = Record(saved);
+        return record != NONE ? mLoaded[record] : INVALID_ENTITY;
+    }
+
+private:
+    friend class WorldSerializer;
+
+    static constexpr std::uint32_t NONE = ~0u;
+
+    // Position of saved in the file's entity list, or NONE.
+    std::uint32_t Record(Entity saved) const {
+        const std::uint32_t slot = EntityIndex(saved);
+        if (saved == INVALID_ENTITY || slot >= mRecordOfSlot.size()) return NONE;
+        const std::uint32_t record = mRecordOfSlot[slot];
+        return record < mSaved.size() && mSaved[record] == saved ? record : NONE;
+    }
+
+    std::vector<std::uint32_t> mRecordOfSlot;
+    std::vector<Entity>        mSaved;
+    std::vector<Entity>        mLoaded;
+};
+
+// Versioned binary save/load of whole worlds.
+//
+// Only registered component types are written. Trivially copyable types
+// (RegisterRaw) are written and read back as one memcpy per pool;
+// anything else goes through a save/load function pair (Register,
+// RegisterShared). Types are matched by the name given at registration, so
+// they can be registered with the ECS in any order; pools in the file with
+// no registered name are skipped on load.
+//
+// Loading adds the saved entities to the world with fresh handles; every
+// Entity stored inside a component must be translated with the
+// EntityRemap the loader passes in (the fixup of RegisterRaw, or the load
+// function). Entity membership is computed up front, so each group of
+// entities sharing a signature is created and announced to systems once.
+//
+// File layout (host byte order):
+//   header   magic "AECW", version, entity count, pool count
+//   entities saved handle per entity
+//   masks    per entity, bit i set when it has the file's pool i
+//   pools    name, kind, element size, payload size, payload
+class WorldSerializer {
+public:
+    static constexpr std::uint32_t FORMAT_VERSION = 1;
+    // One mask bit per pool in the file.
+    static constexpr std::size_t MAX_POOLS = 32;
+
+    // T is stored as raw bytes; fixup (optional) rewrites its Entity fields
+    // after loading.
+    template<typename T>
+    void RegisterRaw(std::string name, void (*fixup)(T&, const EntityRemap&) = nullptr) {
+        static_assert(std::is_trivially_copyable_v<T>, "RegisterRaw needs a trivially copyable component; use Register.");
+        Entry entry = MakeEntry<T>(std::move(name), Kind::Raw, static_cast<std::uint32_t>(sizeof(T)));
+        entry.save = [](ComponentManager& components, WorldWriter& out) {
+            auto* pool = components.GetComponentArray<T>();
+            const std::uint32_t count = pool->IsTag() ? 0u : static_cast<std::uint32_t>(pool->Size());
+            out.Write(count);
+            out.WriteBytes(pool->Entities(), count * sizeof(Entity));
+            out.WriteBytes(pool->Data(), count * sizeof(T));
+        };
+        entry.load = [fixup](ComponentManager& components, WorldReader& in, const EntityRemap& remap,
+            std::vector<std::uint8_t>& pending)
+        {
+            auto* pool = components.GetComponentArray<T>();
+            const std::uint32_t count = in.Read<std::uint32_t>();
+            if (pool->IsTag()) {
+                // Tags are saved as mask bits alone.
+                std::fill(pending.begin(), pending.end(), std::uint8_t(0));
+                return count == 0;
+            }
+            const std::byte* saved = in.Take(std::size_t(count) * sizeof(Entity));
+            const std::byte* data = in.Take(std::size_t(count) * sizeof(T));
+            if (!saved || !data) return false;
+
+            std::vector<Entity> entities(count);
+            if (!RemapAll(saved, count, remap, pending, entities.data())) return false;
+            pool->AppendRaw(entities.data(), data, count);
+            if (fixup) {
+                for (const Entity e : entities) fixup(*pool->TryGetData(e), remap);
+            }
+            return true;
+        };
+        Add(std::move(entry));
+    }
+
+    // T is written with save and rebuilt with load, one component at a time.
+    template<typename T>
+    void Register(std::string name, void (*save)(const T&, WorldWriter&),
+        T (*load)(WorldReader&, const EntityRemap&))
+    {
+        Entry entry = MakeEntry<T>(std::move(name), Kind::Custom, 0);
+        entry.save = [save](ComponentManager& components, WorldWriter& out) {
+            auto* pool = components.GetComponentArray<T>();
+            const std::uint32_t count = static_cast<std::uint32_t>(pool->Size());
+            out.Write(count);
+            out.WriteBytes(pool->Entities(), count * sizeof(Entity));
+            for (std::uint32_t i = 0; i < count; ++i) save(pool->Data()[i], out);
+        };
+        entry.load = [load](ComponentManager& components, WorldReader& in, const EntityRemap& remap,
+            std::vector<std::uint8_t>& pending)
+        {
+            auto* pool = components.GetComponentArray<T>();
+            const std::uint32_t count = in.Read<std::uint32_t>();
+            const std::byte* saved = in.Take(std::size_t(count) * sizeof(Entity));
+            if (!saved) return false;
+
+            std::vector<Entity> entities(count);
+            if (!RemapAll(saved, count, remap, pending, entities.data())) return false;
+            pool->Reserve(count);
+            for (const Entity e : entities) {
+                T value = load(in, remap);
+                if (!in.Ok()) return false;
+                pool->Emplace(e, std::move(value));
+            }
+            return true;
+        };
+        Add(std::move(entry));
+    }
+
+    // Shared (flyweight) component: each distinct value is saved once,
+    // followed by the entities pointing at it.
+    template<typename T>
+    void RegisterShared(std::string name, void (*save)(const T&, WorldWriter&),
+        T (*load)(WorldReader&, const EntityRemap&))
+    {
+        Entry entry = MakeEntry<T>(std::move(name), Kind::Shared, 0);
+        entry.save = [save](ComponentManager& components, WorldWriter& out) {
+            auto* pool = components.GetSharedArray<T>();
+            out.Write(static_cast<std::uint32_t>(pool->ValueCount()));
+            pool->EachGroup([&](const T& value, const Entity* entities, std::size_t count) {
+                save(value, out);
+                out.Write(static_cast<std::uint32_t>(count));
+                out.WriteBytes(entities, count * sizeof(Entity));
+            });
+        };
+        entry.load = [load](ComponentManager& components, WorldReader& in, const EntityRemap& remap,
+            std::vector<std::uint8_t>& pending)
+        {
+            auto* pool = components.GetSharedArray<T>();
+            const std::uint32_t values = in.Read<std::uint32_t>();
+            std::vector<Entity> entities;
+            for (std::uint32_t v = 0; v < values; ++v) {
+                const T value = load(in, remap);
+                const std::uint32_t count = in.Read<std::uint32_t>();
+                const std::byte* saved = in.Take(std::size_t(count) * sizeof(Entity));
+                if (!saved) return false;
+
+                entities.resize(count);
+                if (!RemapAll(saved, count, remap, pending, entities.data())) return false;
+                for (const Entity e : entities) pool->Set(e, value);
+            }
+            return in.Ok();
+        };
+        Add(std::move(entry));
+    }
+
+    // Every registered type must also be registered with ecs (shared types
+    // as shared). Entities with none of the registered types are still
+    // saved, empty.
+    std::vector<std::byte> SaveToMemory(ECS& ecs) const;
+    bool Save(ECS& ecs, const std::string& path, std::string* error = nullptr) const;
+
+    // Adds the saved world to ecs, which need not be empty. On success,
+    // loaded (optional) receives the new handle of every saved entity in
+    // file order. A file that fails the header or pool checks leaves ecs
+    // untouched. Component data is only checked while it is loaded; if it
+    // turns out corrupt, the entities created for the file are destroyed
+    // again, so ecs keeps the entities and components it had (the freed
+    // slots' generations have moved on).
+    bool LoadFromMemory(ECS& ecs, const void* data, std::size_t size,
+        std::vector<Entity>* loaded = nullptr, std::string* error = nullptr) const;
+    bool Load(ECS& ecs, const std::string& path,
+        std::vector<Entity>* loaded = nullptr, std::string* error = nullptr) const;
+
+private:
+    enum class Kind : std::uint32_t { Raw = 0, Custom = 1, Shared = 2 };
+
+    struct Entry {
+        std::string   name;
+        Kind          kind = Kind::Raw;
+        std::uint32_t elementSize = 0;
+        std::function<bool(ComponentManager&)>          registered;
+        std::function<ComponentType(ComponentManager&)> type;
+        std::function<void(ComponentManager&, WorldWriter&)> save;
+        // pending: see RemapAll.
+        std::function<bool(ComponentManager&, WorldReader&, const EntityRemap&, std::vector<std::uint8_t>&)> load;
+    };
+
+    template<typename T>
+    static Entry MakeEntry(std::string name, Kind kind, std::uint32_t elementSize) {
+        Entry entry;
+        entry.name = std::move(name);
+        entry.kind = kind;
+        entry.elementSize = elementSize;
+        entry.registered = [kind](ComponentManager& components) {
+            return components.IsRegistered<T>() && components.IsShared<T>() == (kind == Kind::Shared);
+        };
+        entry.type = [](ComponentManager& components) { return components.GetComponentType<T>(); };
+        return entry;
+    }
+
+    // Saved handles (possibly unaligned) to loaded ones. pending[record]
+    // is set for each entity whose mask says it has the pool being loaded
+    // and that hasn't been listed yet; false if a handle isn't one of
+    // those. The loader checks that none are left pending afterwards.
+    static bool RemapAll(const std::byte* saved, std::uint32_t count, const EntityRemap& remap,
+        std::vector<std::uint8_t>& pending, Entity* out)
+    {
+        for (std::uint32_t i = 0; i < count; ++i) {
+            Entity e;
+            std::memcpy(&e, saved + std::size_t(i) * sizeof(Entity), sizeof(Entity));
+            const std::uint32_t record = remap.Record(e);
+            if (record == EntityRemap::NONE || !pending[record]) return false;
+            pending[record] = 0;
+            out[i] = remap.mLoaded[record];
+        }
+        return true;
+    }
+
+    void Add(Entry entry) {
+        for (const Entry& existing : mEntries) {
+            assert(existing.name != entry.name && "Component name registered twice.");
+        }
+        assert(mEntries.size() < MAX_POOLS && "Too many serialized component types.");
+        mEntries.push_back(std::move(entry));
+    }
+
+    std::vector<Entry> mEntries;
+};
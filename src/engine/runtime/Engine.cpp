@@ -3,9 +3,11 @@
 #include "Window.h"
 #include "Diagnostics.h"
 #include "GpuTimers.h"
+#include "GLCommandQueue.h"
 #include "Platform.h"
 #include "InputState.h"
 #include "InputBackend.h"
+#include "JobSystem.h"
 #include "RenderDeviceGL.h"
 #include "EditorUI.h"
 
@@ -16,9 +18,19 @@
 #include <SDL3/SDL.h>
 #include <iostream>
 
+namespace {
+    // Per-frame time for GL work queued by workers (uploads, fences).
+    constexpr double kGLQueueBudgetMs = 2.0;
+}
+
 Engine::Engine(Window* window)
     : mWindow(window)
 {
+    // Workers for the ECS scheduler; systems without declared access still
+    // run on this thread.
+    diag::SetThreadName("Main");
+    jobs::Initialize();
+
     mPerfFreq = SDL_GetPerformanceFrequency();
     mLastPerfCounter = SDL_GetPerformanceCounter();
     mFrameIndex = 0;
@@ -39,12 +51,19 @@ Engine::Engine(Window* window)
         return;
     }
 
+    // GL work queued by workers is run here, on the context's thread.
+    GetGLCommandQueue().bindToCurrentThread();
+
     // Diagnostics GPU pool requires GL entry points to be loaded first.
     diag::BindGlobalGpuPool();
     diag::Diagnostics::I().setOverlayVisible(true);
 }
 
-Engine::~Engine() = default;
+Engine::~Engine()
+{
+    // No-op if Shutdown() already stopped the workers.
+    jobs::Shutdown();
+}
 
 SystemManager& Engine::getSystemManager() {
     return mECS.GetSystemManager();
@@ -77,11 +96,18 @@ void Engine::Update(float dt)
     diag::Diagnostics::I().beginFrame(mFrameIndex);
     {
         AssetMemorySummary mem = mAssets.SummarizeMemory();
-        diag::EngineMemory em{};
+        diag::EngineMemory& em = mEngineMemory;
+        em.ecs_pools.clear();
         em.textures = mem.textures;
         em.buffers = mem.buffers;
         em.meshes = mem.meshes;
         em.other = mem.other;
+
+        em.ecs_entities = mECS.GetEntityManager().BytesReserved();
+        em.ecs_systems = mECS.GetSystemManager().MembershipBytes();
+        mECS.GetComponentManager().EachPoolMemory([&em](const char* name, const PoolMemory& pool) {
+            em.ecs_pools.push_back(diag::EcsPoolMemory{ name, pool.capacity, pool.live, pool.bytesReserved, pool.bytesUsed });
+        });
         diag::Diagnostics::I().publishEngineMemory(em);
     }
 
@@ -93,6 +119,18 @@ void Engine::Update(float dt)
     // 3) Run ECS systems first
     mECS.Update(dt);
 
+    // 3a) Per-system timings and budgets for the overlay
+    mECS.GetSystemManager().EachTiming([](const SystemTiming& t) {
+        diag::Diagnostics::I().addSystemSample(t.name, t.ms, t.entities, t.budgetMs);
+    });
+
+    // 3b) Freeze tracked pools for readers of this frame (render upload)
+    mSnapshots.Publish();
+
+    // 3c) GL work workers queued (uploads, fences), within budget
+    if (mGraphicsInitialized)
+        GetGLCommandQueue().drain(kGLQueueBudgetMs);
+
     // 4) Build UI windows
     editor::DrawEditorUI();
     diag::Diagnostics::I().drawOverlay();
@@ -143,6 +181,17 @@ void Engine::Update(float dt)
 
 void Engine::Shutdown()
 {
+    // Workers may still be decoding and submitting; stop them first so
+    // the drain below sees everything they will ever queue.
+    jobs::Shutdown();
+
+    // Finish queued GL work while the context is still alive.
+    if (mGraphicsInitialized)
+    {
+        GetGLCommandQueue().drain(-1.0);
+        GetGLCommandQueue().unbind();
+    }
+
     if (mRenderDevice)
         mRenderDevice->shutdown();
 
@@ -3,8 +3,10 @@
 #include "Window.h"
 #include "AssetManager.h"
 #include "ECS.h"
+#include "Snapshot.h"
 #include "InputState.h"
 #include "InputBackend.h"
+#include "Metrics.h"
 
 #include <cstdint>
 #include <memory>
@@ -19,6 +21,7 @@ public:
 
     AssetManager& getAssetManager() { return mAssets; }
     ECS& getECS() { return mECS; }
+    SnapshotPublisher& getSnapshots() { return mSnapshots; }
     SystemManager& getSystemManager();
 
     bool PollEvents();
@@ -34,11 +37,15 @@ private:
     Window* mWindow;
     AssetManager mAssets;
     ECS          mECS;
+    SnapshotPublisher mSnapshots{ mECS };
 
     std::uint64_t mFrameIndex = 0;
     std::uint64_t mLastPerfCounter = 0;
     std::uint64_t mPerfFreq = 0;
 
+    // Refilled every frame; kept so its pool list isn't reallocated.
+    diag::EngineMemory mEngineMemory;
+
     plat::InputState   mInputState{};
     plat::InputBackend mInputBackend;
 
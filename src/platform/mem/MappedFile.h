@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace plat {
+
+    // Read-only view of a whole file mapped into memory. Pages are faulted
+    // in on first touch, so opening a large file costs almost nothing until
+    // it is read.
+    class MappedFile {
+    public:
+        MappedFile() = default;
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        // False if the file can't be opened or mapped. An empty file opens
+        // with Data() == nullptr.
+        bool Open(const std::string& path);
+        void Close();
+
+        const void* Data() const { return mData; }
+        std::size_t Size() const { return mSize; }
+
+    private:
+        const void* mData = nullptr;
+        std::size_t mSize = 0;
+        void*       mHandle = nullptr;
+    };
+
+}
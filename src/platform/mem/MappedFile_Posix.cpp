@@ -0,0 +1,46 @@
+#if defined(__linux__) || defined(__APPLE__)
+#include "MappedFile.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace plat {
+
+    MappedFile::~MappedFile() {
+        Close();
+    }
+
+    bool MappedFile::Open(const std::string& path) {
+        Close();
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+
+        struct stat st {};
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            return false;
+        }
+
+        // The mapping keeps the file referenced; the descriptor isn't needed.
+        void* data = nullptr;
+        if (st.st_size > 0) {
+            data = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        }
+        ::close(fd);
+        if (data == MAP_FAILED) return false;
+
+        mData = data;
+        mSize = static_cast<std::size_t>(st.st_size);
+        return true;
+    }
+
+    void MappedFile::Close() {
+        if (mData) ::munmap(const_cast<void*>(mData), mSize);
+        mData = nullptr;
+        mSize = 0;
+    }
+
+}
+#endif
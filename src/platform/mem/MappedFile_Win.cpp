@@ -0,0 +1,57 @@
+#ifdef _WIN32
+#include "MappedFile.h"
+
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+
+namespace plat {
+
+    MappedFile::~MappedFile() {
+        Close();
+    }
+
+    bool MappedFile::Open(const std::string& path) {
+        Close();
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+            FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return false;
+
+        LARGE_INTEGER size{};
+        if (!GetFileSizeEx(file, &size)) {
+            CloseHandle(file);
+            return false;
+        }
+        if (size.QuadPart == 0) {
+            CloseHandle(file);
+            return true;
+        }
+
+        // The view keeps the mapping alive, and the mapping keeps the file.
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file);
+        if (!mapping) return false;
+
+        const void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (!data) {
+            CloseHandle(mapping);
+            return false;
+        }
+
+        mData = data;
+        mSize = static_cast<std::size_t>(size.QuadPart);
+        mHandle = mapping;
+        return true;
+    }
+
+    void MappedFile::Close() {
+        if (mData) UnmapViewOfFile(mData);
+        if (mHandle) CloseHandle(static_cast<HANDLE>(mHandle));
+        mData = nullptr;
+        mSize = 0;
+        mHandle = nullptr;
+    }
+
+}
+#endif
@@ -0,0 +1,13 @@
+#pragma once
+
+namespace plat {
+
+    // Name shown for the calling thread in debuggers and profilers. Linux
+    // keeps the first 15 characters.
+    bool SetCurrentThreadName(const char* name);
+
+    // Restricts the calling thread to one logical CPU. False if the CPU
+    // doesn't exist or the platform doesn't support pinning (macOS).
+    bool PinCurrentThread(unsigned cpu);
+
+}
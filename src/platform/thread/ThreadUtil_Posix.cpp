@@ -0,0 +1,36 @@
+#if defined(__linux__) || defined(__APPLE__)
+#include "ThreadUtil.h"
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <cstring>
+
+namespace plat {
+
+    bool SetCurrentThreadName(const char* name) {
+#if defined(__APPLE__)
+        return pthread_setname_np(name) == 0;
+#else
+        char truncated[16];
+        std::strncpy(truncated, name, sizeof(truncated) - 1);
+        truncated[sizeof(truncated) - 1] = '\0';
+        return pthread_setname_np(pthread_self(), truncated) == 0;
+#endif
+    }
+
+    bool PinCurrentThread(unsigned cpu) {
+#if defined(__APPLE__)
+        (void)cpu;
+        return false;
+#else
+        if (cpu >= CPU_SETSIZE) return false;
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#endif
+    }
+
+}
+#endif
@@ -0,0 +1,27 @@
+#ifdef _WIN32
+#include "ThreadUtil.h"
+
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+
+#include <string>
+
+namespace plat {
+
+    bool SetCurrentThreadName(const char* name) {
+        const int length = MultiByteToWideChar(CP_UTF8, 0, name, -1, nullptr, 0);
+        if (length <= 0) return false;
+        std::wstring wide(static_cast<std::size_t>(length), L'\0');
+        MultiByteToWideChar(CP_UTF8, 0, name, -1, wide.data(), length);
+        return SUCCEEDED(SetThreadDescription(GetCurrentThread(), wide.c_str()));
+    }
+
+    bool PinCurrentThread(unsigned cpu) {
+        if (cpu >= sizeof(DWORD_PTR) * 8) return false;
+        return SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << cpu) != 0;
+    }
+
+}
+#endif
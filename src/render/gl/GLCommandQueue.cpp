@@ -0,0 +1,132 @@
+#include "GLCommandQueue.h"
+#include "Chrono.h"
+#include "Instrument.h"
+
+#include <cassert>
+
+GLCommandQueue::GLCommandQueue()
+    : mHead(&mStub), mTail(&mStub)
+{
+}
+
+GLCommandQueue::~GLCommandQueue()
+{
+    // Whatever was never drained is dropped; its futures report
+    // broken_promise.
+    while (Node* node = pop()) delete node;
+}
+
+void GLCommandQueue::bindToCurrentThread()
+{
+    mOwner = std::this_thread::get_id();
+    mBound.store(true, std::memory_order_release);
+}
+
+void GLCommandQueue::unbind()
+{
+    mBound.store(false, std::memory_order_release);
+    mOwner = std::thread::id{};
+}
+
+void GLCommandQueue::push(Node* node)
+{
+    node->next.store(nullptr, std::memory_order_relaxed);
+    mPending.fetch_add(1, std::memory_order_relaxed);
+    Node* prev = mHead.exchange(node, std::memory_order_acq_rel);
+    // Between the exchange and this store the list is briefly cut; pop()
+    // sees that as empty and picks the node up on a later drain.
+    prev->next.store(node, std::memory_order_release);
+}
+
+GLCommandQueue::Node* GLCommandQueue::pop()
+{
+    Node* tail = mTail;
+    Node* next = tail->next.load(std::memory_order_acquire);
+    if (tail == &mStub) {
+        if (!next) return nullptr;
+        mTail = next;
+        tail = next;
+        next = next->next.load(std::memory_order_acquire);
+    }
+    if (next) {
+        mTail = next;
+        return tail;
+    }
+    if (tail != mHead.load(std::memory_order_acquire)) return nullptr;
+
+    // tail is the last node; put the stub behind it so it can be handed out.
+    push(&mStub);
+    mPending.fetch_sub(1, std::memory_order_relaxed);
+    next = tail->next.load(std::memory_order_acquire);
+    if (next) {
+        mTail = next;
+        return tail;
+    }
+    return nullptr;
+}
+
+std::size_t GLCommandQueue::drain(double budgetMs)
+{
+    assert(isOwnerThread() && "GLCommandQueue drained off the GL thread");
+    ZONE_CPU("GLCommandQueue::drain");
+
+    const std::int64_t start = diag::now_ns();
+    const std::int64_t deadline = budgetMs < 0.0
+        ? INT64_MAX
+        : start + static_cast<std::int64_t>(budgetMs * 1'000'000.0);
+
+    std::size_t ran = 0;
+    std::int64_t now = start;
+    while (ran == 0 || now < deadline) {
+        Node* node = pop();
+        if (!node) break;
+        mPending.fetch_sub(1, std::memory_order_relaxed);
+        node->run();
+        delete node;
+        ++ran;
+        now = diag::now_ns();
+    }
+
+    mLast.ran = ran;
+    mLast.left = pending();
+    mLast.ms = diag::ns_to_ms(now - start);
+    return ran;
+}
+
+GLCommandQueue& GetGLCommandQueue()
+{
+    static GLCommandQueue queue;
+    return queue;
+}
+
+namespace gl {
+
+    std::future<GLuint> SubmitBufferUpload(GLenum target, std::vector<std::uint8_t> bytes, GLenum usage)
+    {
+        return GetGLCommandQueue().submit([target, usage, bytes = std::move(bytes)]() {
+            GLuint id = 0;
+            glGenBuffers(1, &id);
+            glBindBuffer(target, id);
+            glBufferData(target, static_cast<GLsizeiptr>(bytes.size()), bytes.data(), usage);
+            glBindBuffer(target, 0);
+            return id;
+        });
+    }
+
+    std::future<void> SubmitBufferSubData(GLenum target, GLuint buffer, GLintptr offset, std::vector<std::uint8_t> bytes)
+    {
+        return GetGLCommandQueue().submit([target, buffer, offset, bytes = std::move(bytes)]() {
+            glBindBuffer(target, buffer);
+            glBufferSubData(target, offset, static_cast<GLsizeiptr>(bytes.size()), bytes.data());
+            glBindBuffer(target, 0);
+        });
+    }
+
+    std::future<GLsync> SubmitFence()
+    {
+        return GetGLCommandQueue().submit([]() {
+            return glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        });
+    }
+
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "GraphicsGL.h"
+
+// GL work queued by any thread, run by the thread that owns the GL context.
+//
+// Workers do the CPU-side preparation (decoding, vertex packing, BVH
+// flattening) and submit only the GL calls; the render thread drains the
+// queue once per frame under a time budget. submit() returns a future for
+// the task's result, and an exception thrown by a task ends up in it.
+// While no thread is bound (graphics failed to start, or the engine has
+// shut down) nothing would ever drain it, so submit() fails right away.
+//
+// The queue is a lock-free multi-producer, single-consumer list (Vyukov's
+// intrusive MPSC queue): submit() is one exchange, and tasks run in the
+// order their exchanges happened.
+class GLCommandQueue
+{
+public:
+    struct Stats
+    {
+        std::size_t ran = 0;        // tasks run by the last drain()
+        std::size_t left = 0;       // tasks still queued after it
+        double      ms = 0.0;       // time it took
+    };
+
+    GLCommandQueue();
+    ~GLCommandQueue();
+
+    GLCommandQueue(const GLCommandQueue&) = delete;
+    GLCommandQueue& operator=(const GLCommandQueue&) = delete;
+
+    // Makes the calling thread the one that drains (the GL context owner).
+    void bindToCurrentThread();
+    // Call once the context is gone; later submits fail instead of queueing.
+    void unbind();
+    bool isBound() const noexcept { return mBound.load(std::memory_order_acquire); }
+    bool isOwnerThread() const noexcept { return isBound() && std::this_thread::get_id() == mOwner; }
+
+    // With no bound thread the task is dropped and the future holds a
+    // std::runtime_error.
+    template <class F>
+    auto submit(F&& fn) -> std::future<std::invoke_result_t<std::decay_t<F>&>>
+    {
+        using R = std::invoke_result_t<std::decay_t<F>&>;
+        if (!isBound()) {
+            std::promise<R> unbound;
+            unbound.set_exception(std::make_exception_ptr(
+                std::runtime_error("GLCommandQueue: no GL thread to run the task")));
+            return unbound.get_future();
+        }
+        auto* task = new Task<R>(std::forward<F>(fn));
+        std::future<R> result = task->work.get_future();
+        push(task);
+        return result;
+    }
+
+    // Owner thread only. Runs queued tasks until budgetMs is spent, always
+    // at least one so a long task can't stall the queue forever; a negative
+    // budget runs everything that is queued.
+    std::size_t drain(double budgetMs);
+
+    std::size_t pending() const noexcept { return mPending.load(std::memory_order_relaxed); }
+    const Stats& lastDrain() const noexcept { return mLast; }
+
+private:
+    struct Node
+    {
+        std::atomic<Node*> next{ nullptr };
+        virtual ~Node() = default;
+        virtual void run() {}
+    };
+
+    template <class R>
+    struct Task final : Node
+    {
+        template <class F>
+        explicit Task(F&& fn) : work(std::forward<F>(fn)) {}
+        void run() override { work(); }
+        std::packaged_task<R()> work;
+    };
+
+    void  push(Node* node);
+    Node* pop();
+
+    alignas(64) std::atomic<Node*> mHead;    // producers
+    alignas(64) Node*              mTail;    // consumer
+    Node                           mStub;
+
+    std::atomic<std::size_t> mPending{ 0 };
+    std::atomic<bool>        mBound{ false };
+    std::thread::id          mOwner{};
+    Stats                    mLast{};
+};
+
+// The queue drained by the engine's render thread.
+GLCommandQueue& GetGLCommandQueue();
+
+namespace gl {
+
+    // Creates a buffer holding bytes; resolves to its name.
+    std::future<GLuint> SubmitBufferUpload(GLenum target, std::vector<std::uint8_t> bytes, GLenum usage = GL_STATIC_DRAW);
+
+    // Replaces [offset, offset + bytes.size()) of an existing buffer.
+    std::future<void> SubmitBufferSubData(GLenum target, GLuint buffer, GLintptr offset, std::vector<std::uint8_t> bytes);
+
+    // Inserts a fence behind everything submitted so far; resolves once it
+    // is in the command stream (not once the GPU has reached it).
+    std::future<GLsync> SubmitFence();
+
+}
@@ -0,0 +1,180 @@
+#include "TransformSystem.h"
+#include "Components.h"
+#include "ECS.h"
+#include "JobSystem.h"
+#include "TransformKernel.h"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+static_assert(sizeof(glm::mat4) == 16 * sizeof(float), "Kernel output is copied straight into glm::mat4.");
+
+TransformSystem::TransformSystem(ECS& ecs)
+    : mEcs(ecs)
+{
+}
+
+std::shared_ptr<TransformSystem> TransformSystem::Register(ECS& ecs)
+{
+    if (!ecs.IsComponentRegistered<Transform>()) ecs.RegisterComponent<Transform>();
+    if (!ecs.IsComponentRegistered<Hierarchy>()) ecs.RegisterComponent<Hierarchy>();
+    if (!ecs.IsComponentRegistered<WorldTransform>()) ecs.RegisterComponent<WorldTransform>();
+
+    auto system = ecs.RegisterSystem<TransformSystem>(ecs);
+    ecs.SetSystemSignature<TransformSystem>(ecs.ComponentMask<Transform, WorldTransform>());
+
+    SystemAccess access;
+    access.reads = ecs.ComponentMask<Transform, Hierarchy>();
+    access.writes = ecs.ComponentMask<WorldTransform>();
+    ecs.SetSystemAccess<TransformSystem>(access);
+    return system;
+}
+
+void TransformSystem::Update(float /*dt*/)
+{
+    const bool rebuild = needsRebuild();
+    if (rebuild) rebuildOrder();
+    propagate(rebuild);
+}
+
+std::uint64_t TransformSystem::structureEpoch()
+{
+    // Members and links only change when an entity gains or loses one of
+    // these types (destroying it counts), which advances that type's epoch.
+    auto& cm = mEcs.GetComponentManager();
+    const EntityManager& entities = mEcs.GetEntityManager();
+    return std::max({ entities.TypeEpoch(cm.GetComponentType<Transform>()),
+                      entities.TypeEpoch(cm.GetComponentType<WorldTransform>()),
+                      entities.TypeEpoch(cm.GetComponentType<Hierarchy>()) });
+}
+
+bool TransformSystem::needsRebuild()
+{
+    if (!mBuilt || structureEpoch() != mBuiltEpoch) return true;
+
+    // Reparenting writes Hierarchy in place. The pool's change-block
+    // summaries skip everything untouched since the last run.
+    bool reparented = false;
+    mEcs.GetComponentManager().GetComponentArray<Hierarchy>()->EachChangedSince(mLastRunTick, [&](std::size_t) {
+        reparented = true;
+    });
+    return reparented;
+}
+
+void TransformSystem::rebuildOrder()
+{
+    auto* links = mEcs.GetComponentManager().GetComponentArray<Hierarchy>();
+
+    std::uint32_t slots = 0;
+    for (Entity e : mEntities) slots = std::max(slots, EntityIndex(e) + 1);
+
+    // Children of each member as intrusive lists keyed by slot index.
+    std::vector<std::uint32_t> firstChild(slots, NO_PARENT);
+    std::vector<std::uint32_t> nextSibling(slots, NO_PARENT);
+    std::vector<Entity>        slotEntity(slots, INVALID_ENTITY);
+    std::vector<Entity>        roots;
+
+    for (Entity e : mEntities) {
+        const std::uint32_t slot = EntityIndex(e);
+        slotEntity[slot] = e;
+
+        const Hierarchy* link = links->TryGetData(e);
+        if (link && link->parent != e && mEntities.Contains(link->parent)) {
+            const std::uint32_t parentSlot = EntityIndex(link->parent);
+            nextSibling[slot] = firstChild[parentSlot];
+            firstChild[parentSlot] = slot;
+        }
+        else {
+            roots.push_back(e);
+        }
+    }
+
+    // Breadth-first per root. Entities caught in a parent cycle are never
+    // reached and keep their last world matrix.
+    mOrder.clear();
+    mParent.clear();
+    mSegments.clear();
+    for (Entity root : roots) {
+        const auto begin = static_cast<std::uint32_t>(mOrder.size());
+        mOrder.push_back(root);
+        mParent.push_back(NO_PARENT);
+
+        for (std::uint32_t i = begin; i < mOrder.size(); ++i) {
+            for (std::uint32_t c = firstChild[EntityIndex(mOrder[i])]; c != NO_PARENT; c = nextSibling[c]) {
+                mOrder.push_back(slotEntity[c]);
+                mParent.push_back(i);
+            }
+        }
+        mSegments.push_back(Segment{ begin, static_cast<std::uint32_t>(mOrder.size()) });
+    }
+
+    mBuiltEpoch = structureEpoch();
+    mBuilt = true;
+}
+
+void TransformSystem::propagate(bool all)
+{
+    auto& cm = mEcs.GetComponentManager();
+    auto* locals = cm.GetComponentArray<Transform>();
+    auto* worlds = cm.GetComponentArray<WorldTransform>();
+    const ChangeTick since = mLastRunTick;
+
+    mRecomputed.assign(mOrder.size(), 0);
+    if (!mScratch) mScratch = std::make_unique<jobs::WorkerLocal<Scratch>>();
+
+    const std::size_t perSegment = mSegments.empty() ? 1 : mOrder.size() / mSegments.size() + 1;
+    const std::size_t grain = jobs::AutoGrain(mSegments.size(),
+        perSegment * (sizeof(Transform) + sizeof(WorldTransform)));
+
+    jobs::ParallelFor(mSegments.size(), grain, [&](std::size_t first, std::size_t last) {
+        Scratch& scratch = mScratch->Local();
+
+        // Dirty entities of these segments, in order. A parent always
+        // precedes its children, so its flag is final by the time they look.
+        scratch.dirty.clear();
+        for (std::size_t s = first; s < last; ++s) {
+            const Segment seg = mSegments[s];
+            for (std::uint32_t i = seg.begin; i < seg.end; ++i) {
+                const std::uint32_t parent = mParent[i];
+                const bool parentMoved = parent != NO_PARENT && mRecomputed[parent];
+                if (!all && !parentMoved && !locals->ChangedSince(mOrder[i], since)) continue;
+                mRecomputed[i] = 1;
+                scratch.dirty.push_back(i);
+            }
+        }
+
+        const std::size_t n = scratch.dirty.size();
+        if (n == 0) return;
+
+        scratch.trs.resize(9 * n);
+        scratch.matrices.resize(16 * n);
+        float* soa = scratch.trs.data();
+        for (std::size_t k = 0; k < n; ++k) {
+            const Transform& t = locals->GetData(mOrder[scratch.dirty[k]]);
+            soa[0 * n + k] = t.position.x; soa[1 * n + k] = t.position.y; soa[2 * n + k] = t.position.z;
+            soa[3 * n + k] = t.rotation.x; soa[4 * n + k] = t.rotation.y; soa[5 * n + k] = t.rotation.z;
+            soa[6 * n + k] = t.scale.x;    soa[7 * n + k] = t.scale.y;    soa[8 * n + k] = t.scale.z;
+        }
+
+        xform::TrsSoA in;
+        in.px = soa + 0 * n; in.py = soa + 1 * n; in.pz = soa + 2 * n;
+        in.rx = soa + 3 * n; in.ry = soa + 4 * n; in.rz = soa + 5 * n;
+        in.sx = soa + 6 * n; in.sy = soa + 7 * n; in.sz = soa + 8 * n;
+        xform::ComposeEuler(in, n, scratch.matrices.data());
+
+        for (std::size_t k = 0; k < n; ++k) {
+            const std::uint32_t i = scratch.dirty[k];
+            const Entity e = mOrder[i];
+            const std::uint32_t parent = mParent[i];
+
+            glm::mat4 local;
+            std::memcpy(&local, scratch.matrices.data() + 16 * k, sizeof(local));
+
+            WorldTransform& world = worlds->GetData(e);
+            world.matrix = parent == NO_PARENT ? local : worlds->GetData(mOrder[parent]).matrix * local;
+            worlds->MarkChanged(e);
+        }
+    });
+}
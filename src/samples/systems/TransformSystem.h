@@ -0,0 +1,62 @@
+#pragma once
+
+#include "ISystem.h"
+#include "Entity.h"
+#include "JobSystem.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class ECS;
+
+// Computes WorldTransform for every entity with Transform + WorldTransform.
+// Entities are kept in a flattened, depth-sorted order: one segment per
+// root, each laid out breadth-first so a parent always precedes its
+// children. Only subtrees under a changed Transform are recomputed, and
+// segments are processed in parallel; local matrices for each batch of
+// dirty entities are built with the SIMD kernel in TransformKernel.h.
+class TransformSystem : public ISystem {
+public:
+    explicit TransformSystem(ECS& ecs);
+    void Update(float dt) override;
+
+    // Registers the components (if needed), the system, its signature and
+    // its scheduler access.
+    static std::shared_ptr<TransformSystem> Register(ECS& ecs);
+
+private:
+    std::uint64_t structureEpoch();
+    bool needsRebuild();
+    void rebuildOrder();
+    void propagate(bool all);
+
+    static constexpr std::uint32_t NO_PARENT = ~0u;
+
+    struct Segment {
+        std::uint32_t begin;
+        std::uint32_t end;
+    };
+
+    // Per-worker gather buffers for the kernel: dirty mOrder indices, their
+    // Transforms as SoA (9 arrays of n floats), and the composed matrices.
+    struct Scratch {
+        std::vector<std::uint32_t> dirty;
+        std::vector<float>         trs;
+        std::vector<float>         matrices;
+    };
+
+    ECS& mEcs;
+
+    // Depth-sorted entities, index of each one's parent in mOrder, and the
+    // per-root ranges of mOrder.
+    std::vector<Entity>        mOrder;
+    std::vector<std::uint32_t> mParent;
+    std::vector<Segment>       mSegments;
+    std::vector<std::uint8_t>  mRecomputed;
+
+    std::unique_ptr<jobs::WorkerLocal<Scratch>> mScratch;
+
+    std::uint64_t mBuiltEpoch = 0;
+    bool          mBuilt = false;
+};
@@ -0,0 +1,130 @@
+#include "Bench.h"
+#include "ArchetypeStorage.h"
+#include "ComponentManager.h"
+#include "EntityManager.h"
+#include "View.h"
+
+#include <memory>
+#include <vector>
+
+// Archetype chunks vs. the per-type ComponentArray pools, same workload on both.
+
+namespace {
+
+    struct BenchPosition { float x = 0.0f, y = 0.0f, z = 0.0f; };
+    struct BenchVelocity { float x = 1.0f, y = 0.5f, z = 0.25f; };
+    struct BenchHealth   { float hp = 100.0f; };
+
+    void RunComponentArray(std::size_t n) {
+        auto em = std::make_unique<EntityManager>();
+        auto cm = std::make_unique<ComponentManager>();
+        cm->RegisterComponent<BenchPosition>();
+        cm->RegisterComponent<BenchVelocity>();
+        cm->RegisterComponent<BenchHealth>();
+
+        std::vector<Entity> entities(n);
+
+        std::int64_t ns = bench::MeasureNs([&] {
+            for (std::size_t i = 0; i < n; ++i) {
+                const Entity e = em->CreateEntity();
+                cm->AddComponent(e, BenchPosition{});
+                cm->AddComponent(e, BenchVelocity{});
+                entities[i] = e;
+            }
+        });
+        bench::Report("ComponentArray", "create+2 comps", n, n, ns);
+
+        ns = bench::MeasureNs([&] {
+            for (Entity e : entities) {
+                BenchPosition& p = cm->GetComponent<BenchPosition>(e);
+                const BenchVelocity& v = cm->GetComponent<BenchVelocity>(e);
+                p.x += v.x; p.y += v.y; p.z += v.z;
+            }
+        });
+        bench::Report("ComponentArray", "iterate pos+vel", n, n, ns);
+
+        ns = bench::MeasureNs([&] {
+            ComponentView<BenchPosition, const BenchVelocity> view(
+                cm->GetComponentArray<BenchPosition>(), cm->GetComponentArray<BenchVelocity>());
+            view.Each([](BenchPosition& p, const BenchVelocity& v) {
+                p.x += v.x; p.y += v.y; p.z += v.z;
+            });
+        });
+        bench::Report("ComponentArray", "view pos+vel", n, n, ns);
+
+        ns = bench::MeasureNs([&] {
+            for (Entity e : entities) cm->AddComponent(e, BenchHealth{});
+        });
+        bench::Report("ComponentArray", "add", n, n, ns);
+
+        ns = bench::MeasureNs([&] {
+            for (Entity e : entities) cm->RemoveComponent<BenchHealth>(e);
+        });
+        bench::Report("ComponentArray", "remove", n, n, ns);
+
+        bench::ReportBytes("ComponentArray", "pool bytes", n, cm->BytesReserved());
+
+        ns = bench::MeasureNs([&] {
+            for (Entity e : entities) {
+                em->DestroyEntity(e);
+                cm->EntityDestroyed(e);
+            }
+        });
+        bench::Report("ComponentArray", "destroy", n, n, ns);
+    }
+
+    void RunArchetype(std::size_t n) {
+        auto em = std::make_unique<EntityManager>();
+        ArchetypeStorage storage;
+        storage.RegisterComponent<BenchPosition>();
+        storage.RegisterComponent<BenchVelocity>();
+        storage.RegisterComponent<BenchHealth>();
+
+        std::vector<Entity> entities(n);
+
+        std::int64_t ns = bench::MeasureNs([&] {
+            for (std::size_t i = 0; i < n; ++i) {
+                const Entity e = em->CreateEntity();
+                storage.AddComponent(e, BenchPosition{});
+                storage.AddComponent(e, BenchVelocity{});
+                entities[i] = e;
+            }
+        });
+        bench::Report("Archetype", "create+2 comps", n, n, ns);
+
+        ns = bench::MeasureNs([&] {
+            storage.ForEach<BenchPosition, BenchVelocity>([](Entity, BenchPosition& p, const BenchVelocity& v) {
+                p.x += v.x; p.y += v.y; p.z += v.z;
+            });
+        });
+        bench::Report("Archetype", "iterate pos+vel", n, n, ns);
+
+        ns = bench::MeasureNs([&] {
+            for (Entity e : entities) storage.AddComponent(e, BenchHealth{});
+        });
+        bench::Report("Archetype", "add", n, n, ns);
+
+        ns = bench::MeasureNs([&] {
+            for (Entity e : entities) storage.RemoveComponent<BenchHealth>(e);
+        });
+        bench::Report("Archetype", "remove", n, n, ns);
+
+        bench::ReportBytes("Archetype", "pool bytes", n, storage.BytesReserved());
+
+        ns = bench::MeasureNs([&] {
+            for (Entity e : entities) {
+                em->DestroyEntity(e);
+                storage.EntityDestroyed(e);
+            }
+        });
+        bench::Report("Archetype", "destroy", n, n, ns);
+    }
+
+}
+
+BENCH_CASE(ArchetypeVsComponentArray) {
+    for (std::size_t n : bench::kSizes) {
+        RunComponentArray(n);
+        RunArchetype(n);
+    }
+}
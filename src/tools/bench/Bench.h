@@ -0,0 +1,71 @@
+#pragma once
+
+#include "Chrono.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Minimal benchmark harness for the standalone bench executable.
+// Cases register themselves with BENCH_CASE and are run by BenchMain.cpp.
+
+namespace bench {
+
+    using CaseFn = void (*)();
+
+    struct Case {
+        const char* name;
+        CaseFn fn;
+    };
+
+    std::vector<Case>& Registry();
+
+    struct Registrar {
+        Registrar(const char* name, CaseFn fn) { Registry().push_back(Case{ name, fn }); }
+    };
+
+    // Heap traffic since startup, counted by the global operator new
+    // replacement in BenchMain.cpp (all threads).
+    struct AllocStats {
+        std::uint64_t count = 0;
+        std::uint64_t bytes = 0;
+    };
+    AllocStats Allocations();
+
+    // Allocations made by the most recent MeasureNs; picked up and cleared
+    // by the next Report.
+    inline AllocStats g_measuredAllocs;
+
+    // Entity counts every scaling case runs at.
+    inline constexpr std::size_t kSizes[] = { 1'000, 10'000, 100'000 };
+
+    template<typename Fn>
+    std::int64_t MeasureNs(Fn&& fn) {
+        const AllocStats a0 = Allocations();
+        const std::int64_t t0 = diag::now_ns();
+        fn();
+        const std::int64_t ns = diag::now_ns() - t0;
+        const AllocStats a1 = Allocations();
+        g_measuredAllocs = AllocStats{ a1.count - a0.count, a1.bytes - a0.bytes };
+        return ns;
+    }
+
+    // Keeps results observable so the optimizer cannot drop the measured work.
+    inline volatile std::uint64_t g_sink = 0;
+    inline void Consume(std::uint64_t v) { g_sink = g_sink ^ v; }
+
+    void Report(const char* group, const char* op, std::size_t n, std::size_t ops, std::int64_t ns);
+    void ReportBytes(const char* group, const char* op, std::size_t n, std::size_t bytes);
+    // A plain count that belongs with the results (worker threads, waves...).
+    void ReportCount(const char* group, const char* op, std::size_t n, std::size_t count);
+
+    // True when the bench was started with --trace; cases that can write a
+    // Chrome trace only do so then.
+    bool TracesEnabled();
+
+}
+
+#define BENCH_CASE(fnName)                                                   \
+    static void fnName();                                                    \
+    static ::bench::Registrar fnName##_registrar{ #fnName, &fnName };        \
+    static void fnName()
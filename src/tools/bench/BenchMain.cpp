@@ -0,0 +1,209 @@
+#include "Bench.h"
+#include "JobSystem.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+
+namespace {
+
+    std::atomic<std::uint64_t> g_allocCount{ 0 };
+    std::atomic<std::uint64_t> g_allocBytes{ 0 };
+
+    void* CountedAlloc(std::size_t size) {
+        g_allocCount.fetch_add(1, std::memory_order_relaxed);
+        g_allocBytes.fetch_add(size, std::memory_order_relaxed);
+        if (void* p = std::malloc(size ? size : 1)) return p;
+        throw std::bad_alloc();
+    }
+
+    // For over-aligned types (alignas above the default new alignment).
+    void* CountedAlignedAlloc(std::size_t size, std::align_val_t align) {
+        g_allocCount.fetch_add(1, std::memory_order_relaxed);
+        g_allocBytes.fetch_add(size, std::memory_order_relaxed);
+        const std::size_t alignment = static_cast<std::size_t>(align);
+#if defined(_MSC_VER)
+        if (void* p = _aligned_malloc(size ? size : 1, alignment)) return p;
+#else
+        // aligned_alloc wants a size that is a multiple of the alignment.
+        const std::size_t rounded = ((size ? size : 1) + alignment - 1) / alignment * alignment;
+        if (void* p = std::aligned_alloc(alignment, rounded)) return p;
+#endif
+        throw std::bad_alloc();
+    }
+
+    void AlignedFree(void* p) {
+#if defined(_MSC_VER)
+        _aligned_free(p);
+#else
+        std::free(p);
+#endif
+    }
+
+    enum class ResultKind { Timing, Bytes, Count };
+
+    // One line of output, kept for the JSON report.
+    struct Result {
+        ResultKind        kind = ResultKind::Timing;
+        std::string       group;
+        std::string       op;
+        std::size_t       n = 0;
+        std::size_t       ops = 0;
+        std::int64_t      ns = 0;
+        bench::AllocStats allocs;
+        std::size_t       value = 0;    // bytes or count
+    };
+
+    bool g_traces = false;
+
+    std::vector<Result>& Results() {
+        static std::vector<Result> results;
+        return results;
+    }
+
+    void WriteJsonString(std::FILE* f, const std::string& s) {
+        std::fputc('"', f);
+        for (const char c : s) {
+            if (c == '"' || c == '\\') std::fputc('\\', f);
+            if (static_cast<unsigned char>(c) < 0x20) std::fprintf(f, "\\u%04x", c);
+            else std::fputc(c, f);
+        }
+        std::fputc('"', f);
+    }
+
+    bool WriteJson(const char* path) {
+        std::FILE* f = std::fopen(path, "w");
+        if (!f) return false;
+        std::fprintf(f, "[\n");
+        const std::vector<Result>& results = Results();
+        for (std::size_t i = 0; i < results.size(); ++i) {
+            const Result& r = results[i];
+            std::fprintf(f, "  {\"group\": ");
+            WriteJsonString(f, r.group);
+            std::fprintf(f, ", \"op\": ");
+            WriteJsonString(f, r.op);
+            std::fprintf(f, ", \"n\": %zu", r.n);
+            if (r.kind == ResultKind::Bytes) {
+                std::fprintf(f, ", \"bytes\": %zu, \"bytes_per_entity\": %.2f",
+                    r.value, r.n ? double(r.value) / double(r.n) : 0.0);
+            }
+            else if (r.kind == ResultKind::Count) {
+                std::fprintf(f, ", \"count\": %zu", r.value);
+            }
+            else {
+                std::fprintf(f, ", \"ops\": %zu, \"ns\": %lld, \"ns_per_op\": %.3f, \"allocs\": %llu, \"alloc_bytes\": %llu",
+                    r.ops, static_cast<long long>(r.ns), r.ops ? double(r.ns) / double(r.ops) : 0.0,
+                    static_cast<unsigned long long>(r.allocs.count), static_cast<unsigned long long>(r.allocs.bytes));
+            }
+            std::fprintf(f, "}%s\n", i + 1 < results.size() ? "," : "");
+        }
+        std::fprintf(f, "]\n");
+        return std::fclose(f) == 0;
+    }
+
+}
+
+// Every heap allocation in the bench goes through here, so reports can say
+// how much a measured operation allocated.
+void* operator new(std::size_t size) { return CountedAlloc(size); }
+void* operator new[](std::size_t size) { return CountedAlloc(size); }
+void  operator delete(void* p) noexcept { std::free(p); }
+void  operator delete[](void* p) noexcept { std::free(p); }
+void  operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void  operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void* operator new(std::size_t size, std::align_val_t align) { return CountedAlignedAlloc(size, align); }
+void* operator new[](std::size_t size, std::align_val_t align) { return CountedAlignedAlloc(size, align); }
+void  operator delete(void* p, std::align_val_t) noexcept { AlignedFree(p); }
+void  operator delete[](void* p, std::align_val_t) noexcept { AlignedFree(p); }
+void  operator delete(void* p, std::size_t, std::align_val_t) noexcept { AlignedFree(p); }
+void  operator delete[](void* p, std::size_t, std::align_val_t) noexcept { AlignedFree(p); }
+
+namespace bench {
+
+    std::vector<Case>& Registry() {
+        static std::vector<Case> cases;
+        return cases;
+    }
+
+    AllocStats Allocations() {
+        return AllocStats{ g_allocCount.load(std::memory_order_relaxed), g_allocBytes.load(std::memory_order_relaxed) };
+    }
+
+    void Report(const char* group, const char* op, std::size_t n, std::size_t ops, std::int64_t ns) {
+        const AllocStats allocs = g_measuredAllocs;
+        g_measuredAllocs = AllocStats{};
+        const double nsPerOp = ops ? double(ns) / double(ops) : 0.0;
+        std::printf("%-24s %-20s n=%-8zu %10.2f ns/op  (%.3f ms, %llu allocs)\n",
+            group, op, n, nsPerOp, diag::ns_to_ms(ns), static_cast<unsigned long long>(allocs.count));
+
+        Result r;
+        r.group = group;
+        r.op = op;
+        r.n = n;
+        r.ops = ops;
+        r.ns = ns;
+        r.allocs = allocs;
+        Results().push_back(std::move(r));
+    }
+
+    void ReportBytes(const char* group, const char* op, std::size_t n, std::size_t bytes) {
+        std::printf("%-24s %-20s n=%-8zu %10.2f KB  (%.1f B/entity)\n",
+            group, op, n, double(bytes) / 1024.0, n ? double(bytes) / double(n) : 0.0);
+
+        Result r;
+        r.group = group;
+        r.op = op;
+        r.n = n;
+        r.value = bytes;
+        r.kind = ResultKind::Bytes;
+        Results().push_back(std::move(r));
+    }
+
+    void ReportCount(const char* group, const char* op, std::size_t n, std::size_t count) {
+        std::printf("%-24s %-20s n=%-8zu %10zu\n", group, op, n, count);
+
+        Result r;
+        r.group = group;
+        r.op = op;
+        r.n = n;
+        r.value = count;
+        r.kind = ResultKind::Count;
+        Results().push_back(std::move(r));
+    }
+
+    bool TracesEnabled() {
+        return g_traces;
+    }
+
+}
+
+// Usage: AidsEngineBench [filter] [--json path] [--trace]
+//   Runs every case whose name contains filter; --json also writes every
+//   result to path (ns/op and allocations per measurement, bytes/entity,
+//   counts). --trace lets cases write Chrome traces to the working directory.
+int main(int argc, char** argv) {
+    const char* filter = nullptr;
+    const char* jsonPath = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc) jsonPath = argv[++i];
+        else if (std::strcmp(argv[i], "--trace") == 0) g_traces = true;
+        else filter = argv[i];
+    }
+
+    jobs::Initialize();
+    for (const bench::Case& c : bench::Registry()) {
+        if (filter && !std::strstr(c.name, filter)) continue;
+        std::printf("== %s\n", c.name);
+        c.fn();
+    }
+    jobs::Shutdown();
+
+    if (jsonPath && !WriteJson(jsonPath)) {
+        std::fprintf(stderr, "can't write %s\n", jsonPath);
+        return 1;
+    }
+    return 0;
+}
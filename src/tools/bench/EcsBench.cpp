@@ -0,0 +1,134 @@
+#include "Bench.h"
+#include "ECS.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+// The core ECS hot paths, one manager at a time: entity create/destroy on
+// EntityManager, add/remove/random get on ComponentManager, membership
+// churn through SystemManager, and multi-component iteration through ECS.
+// Random orders use a fixed seed so runs are comparable; allocation counts
+// come with every line, and resident bytes per entity close each size.
+
+namespace {
+
+    struct BenchEcsPos { float x = 0.0f, y = 0.0f, z = 0.0f; };
+    struct BenchEcsVel { float x = 1.0f, y = 0.0f, z = 0.0f; };
+    struct BenchEcsHealth { float value = 100.0f; };
+
+    class BenchEcsMover : public ISystem {
+    public:
+        void Update(float) override {}
+    };
+
+    std::vector<Entity> Shuffled(std::vector<Entity> entities) {
+        std::mt19937 rng(1234);
+        std::shuffle(entities.begin(), entities.end(), rng);
+        return entities;
+    }
+
+}
+
+BENCH_CASE(EcsBench) {
+    for (std::size_t n : bench::kSizes) {
+        // EntityManager: fresh slots, destroy in random order, reuse.
+        {
+            EntityManager entities;
+            std::vector<Entity> created(n);
+            std::int64_t ns = bench::MeasureNs([&] {
+                for (std::size_t i = 0; i < n; ++i) created[i] = entities.CreateEntity();
+            });
+            bench::Report("Ecs.EntityManager", "create", n, n, ns);
+
+            const std::vector<Entity> order = Shuffled(created);
+            ns = bench::MeasureNs([&] {
+                for (const Entity e : order) entities.DestroyEntity(e);
+            });
+            bench::Report("Ecs.EntityManager", "destroy (random)", n, n, ns);
+
+            ns = bench::MeasureNs([&] {
+                for (std::size_t i = 0; i < n; ++i) created[i] = entities.CreateEntity();
+            });
+            bench::Report("Ecs.EntityManager", "create (reuse)", n, n, ns);
+        }
+
+        // ComponentManager: storage alone, no signatures or systems.
+        {
+            EntityManager entities;
+            ComponentManager components;
+            components.RegisterComponent<BenchEcsPos>();
+            std::vector<Entity> created(n);
+            for (std::size_t i = 0; i < n; ++i) created[i] = entities.CreateEntity();
+            const std::vector<Entity> order = Shuffled(created);
+
+            std::int64_t ns = bench::MeasureNs([&] {
+                for (const Entity e : created) components.AddComponent(e, BenchEcsPos{});
+            });
+            bench::Report("Ecs.ComponentManager", "add", n, n, ns);
+
+            float sum = 0.0f;
+            ns = bench::MeasureNs([&] {
+                for (const Entity e : order) sum += components.GetComponent<BenchEcsPos>(e).x;
+            });
+            bench::Consume(static_cast<std::uint64_t>(sum));
+            bench::Report("Ecs.ComponentManager", "get (random)", n, n, ns);
+
+            ns = bench::MeasureNs([&] {
+                for (const Entity e : order) components.RemoveComponent<BenchEcsPos>(e);
+            });
+            bench::Report("Ecs.ComponentManager", "remove (random)", n, n, ns);
+        }
+
+        // SystemManager: toggling Vel moves entities in and out of a
+        // {Pos, Vel} system, through the full ECS path.
+        {
+            ECS ecs;
+            ecs.RegisterComponent<BenchEcsPos>();
+            ecs.RegisterComponent<BenchEcsVel>();
+            ecs.RegisterSystem<BenchEcsMover>();
+            ecs.SetSystemSignature<BenchEcsMover>(ecs.ComponentMask<BenchEcsPos, BenchEcsVel>());
+            const std::vector<Entity> entities = ecs.CreateEntities(n, BenchEcsPos{});
+            const std::vector<Entity> order = Shuffled(entities);
+
+            const std::int64_t ns = bench::MeasureNs([&] {
+                for (const Entity e : order) ecs.AddComponent(e, BenchEcsVel{});
+                for (const Entity e : order) ecs.RemoveComponent<BenchEcsVel>(e);
+            });
+            bench::Consume(ecs.GetSystemManager().GetSystem<BenchEcsMover>()->mEntities.Size());
+            bench::Report("Ecs.SystemManager", "signature churn", n, n * 2, ns);
+        }
+
+        // ECS: two- and three-component iteration, where Health is on every
+        // other entity so the three-way view has to skip.
+        {
+            ECS ecs;
+            ecs.RegisterComponent<BenchEcsPos>();
+            ecs.RegisterComponent<BenchEcsVel>();
+            ecs.RegisterComponent<BenchEcsHealth>();
+            const std::vector<Entity> entities = ecs.CreateEntities(n, BenchEcsPos{}, BenchEcsVel{});
+            for (std::size_t i = 0; i < n; i += 2) ecs.AddComponent(entities[i], BenchEcsHealth{});
+
+            std::int64_t ns = bench::MeasureNs([&] {
+                ecs.View<BenchEcsPos, const BenchEcsVel>().Each([](BenchEcsPos& p, const BenchEcsVel& v) {
+                    p.x += v.x; p.y += v.y; p.z += v.z;
+                });
+            });
+            bench::Report("Ecs.ECS", "iterate Pos+Vel", n, n, ns);
+
+            float sum = 0.0f;
+            ns = bench::MeasureNs([&] {
+                ecs.View<const BenchEcsPos, const BenchEcsVel, const BenchEcsHealth>().Each(
+                    [&](const BenchEcsPos& p, const BenchEcsVel&, const BenchEcsHealth& h) { sum += p.x + h.value; });
+            });
+            bench::Consume(static_cast<std::uint64_t>(sum));
+            bench::Report("Ecs.ECS", "iterate Pos+Vel+Hp", n, n, ns);
+
+            const EntityManager& em = ecs.GetEntityManager();
+            const std::size_t bytes = ecs.GetComponentManager().BytesReserved()
+                + em.Slots().capacity() * sizeof(Entity)
+                + em.Signatures().capacity() * sizeof(Signature);
+            bench::ReportBytes("Ecs.ECS", "resident", n, bytes);
+        }
+    }
+}
@@ -0,0 +1,53 @@
+#include "Bench.h"
+#include "ECS.h"
+
+#include <vector>
+
+// Joining two pools whose entries are ordered independently (every other
+// entity has the second component, added in reverse) vs the same pools
+// kept in lockstep by an owning group, plus what the group costs on add
+// and remove.
+
+namespace {
+
+    struct BenchGroupPos { float x = 0.0f, y = 0.0f, z = 0.0f; };
+    struct BenchGroupVel { float x = 1.0f, y = 0.5f, z = 0.25f; };
+
+    void Populate(ECS& ecs, std::size_t n, std::vector<Entity>& entities) {
+        entities = ecs.CreateEntities(n, BenchGroupPos{});
+        for (std::size_t i = n; i-- > 0;) {
+            if (i % 2 == 0) ecs.AddComponent(entities[i], BenchGroupVel{});
+        }
+    }
+
+}
+
+BENCH_CASE(GroupBench) {
+    for (std::size_t n : bench::kSizes) {
+        for (const bool grouped : { false, true }) {
+            const char* group = grouped ? "Group owning" : "Group none";
+
+            ECS ecs;
+            ecs.RegisterComponent<BenchGroupPos>();
+            ecs.RegisterComponent<BenchGroupVel>();
+            if (grouped) ecs.RegisterGroup<BenchGroupPos, BenchGroupVel>();
+
+            std::vector<Entity> entities;
+            std::int64_t ns = bench::MeasureNs([&] { Populate(ecs, n, entities); });
+            bench::Report(group, "populate", n, n, ns);
+
+            auto view = ecs.View<BenchGroupPos, const BenchGroupVel>();
+            ns = bench::MeasureNs([&] {
+                view.Each([](BenchGroupPos& p, const BenchGroupVel& v) {
+                    p.x += v.x; p.y += v.y; p.z += v.z;
+                });
+            });
+            bench::Report(group, "view pos+vel", n, n / 2, ns);
+
+            ns = bench::MeasureNs([&] {
+                for (std::size_t i = 0; i < n; i += 2) ecs.RemoveComponent<BenchGroupVel>(entities[i]);
+            });
+            bench::Report(group, "remove vel", n, n / 2, ns);
+        }
+    }
+}
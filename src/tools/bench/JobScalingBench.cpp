@@ -0,0 +1,103 @@
+#include "Bench.h"
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+// Job system scaling with the worker count: a compute-bound ParallelFor,
+// raw throughput of tiny jobs queued from outside the pool (injection
+// queue) and from inside it (workers' own deques, stolen by the rest), and
+// a chain of RunAfter dependencies. n is the thread count (workers plus
+// the caller). Restores the default pool afterwards.
+
+namespace {
+
+    constexpr std::size_t kItems = 1'000'000;
+    constexpr std::size_t kTinyJobs = 100'000;
+    constexpr std::size_t kChain = 1'000;
+
+    float Work(std::size_t i) {
+        float x = float(i & 1023);
+        for (int k = 0; k < 16; ++k) x = std::sqrt(x * x + 1.0f) - 0.5f;
+        return x;
+    }
+
+    void RunAt(unsigned workers) {
+        jobs::Shutdown();
+        jobs::Initialize(workers);
+        const std::size_t threads = std::size_t(jobs::WorkerCount()) + 1;
+
+        std::vector<float> out(kItems);
+        std::int64_t ns = bench::MeasureNs([&] {
+            jobs::ParallelFor(kItems, jobs::AutoGrain(kItems, sizeof(float)), [&](std::size_t begin, std::size_t end) {
+                for (std::size_t i = begin; i < end; ++i) out[i] = Work(i);
+            });
+        });
+        bench::Consume(static_cast<std::uint64_t>(out[kItems / 2]));
+        bench::Report("Jobs parallel for", "sqrt chain", threads, kItems, ns);
+
+        std::atomic<std::size_t> ran{ 0 };
+        ns = bench::MeasureNs([&] {
+            jobs::Counter counter;
+            for (std::size_t i = 0; i < kTinyJobs; ++i) {
+                jobs::Run([&ran] { ran.fetch_add(1, std::memory_order_relaxed); }, &counter);
+            }
+            jobs::WaitFor(counter);
+        });
+        bench::Report("Jobs tiny", "from outside", threads, kTinyJobs, ns);
+
+        // One job per thread fans out the rest from inside the pool.
+        ns = bench::MeasureNs([&] {
+            jobs::Counter counter;
+            const std::size_t perFan = kTinyJobs / threads;
+            for (std::size_t f = 0; f < threads; ++f) {
+                jobs::Run([&ran, &counter, perFan] {
+                    for (std::size_t i = 0; i < perFan; ++i) {
+                        jobs::Run([&ran] { ran.fetch_add(1, std::memory_order_relaxed); }, &counter);
+                    }
+                }, &counter);
+            }
+            jobs::WaitFor(counter);
+        });
+        bench::Report("Jobs tiny", "fan-out in pool", threads, kTinyJobs, ns);
+        bench::Consume(ran.load());
+
+        ns = bench::MeasureNs([&] {
+            std::vector<jobs::Counter> links(kChain);
+            jobs::Run([] {}, &links[0]);
+            for (std::size_t i = 1; i < kChain; ++i) {
+                jobs::RunAfter(links[i - 1], [] {}, &links[i]);
+            }
+            jobs::WaitFor(links.back());
+        });
+        bench::Report("Jobs dependency", "chain", threads, kChain, ns);
+    }
+
+}
+
+BENCH_CASE(JobScalingBench) {
+    // Single-thread baseline for the compute case.
+    std::vector<float> out(kItems);
+    const std::int64_t ns = bench::MeasureNs([&] {
+        for (std::size_t i = 0; i < kItems; ++i) out[i] = Work(i);
+    });
+    bench::Consume(static_cast<std::uint64_t>(out[kItems / 2]));
+    bench::Report("Jobs parallel for", "serial", 1, kItems, ns);
+
+    const unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+    bool ran = false;
+    for (unsigned workers : { 1u, 3u, 7u, 15u, 31u }) {
+        if (workers >= hw) break;
+        RunAt(workers);
+        ran = true;
+    }
+    if (!ran) {
+        std::printf("single hardware thread: running the default (inline) pool only\n");
+        RunAt(0);
+    }
+    jobs::Shutdown();
+    jobs::Initialize();
+}
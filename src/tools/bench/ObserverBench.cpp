@@ -0,0 +1,85 @@
+#include "Bench.h"
+#include "ECS.h"
+
+#include <vector>
+
+// Reacting to the 1% of entities that gained or changed a mesh-like
+// component in a frame: polling a view with an Added/Changed filter walks
+// the whole pool, while an observer is handed only the affected entities
+// at the sync point (changes are found through the pool's per-block change
+// summary). Also the overhead observers add to structural changes.
+
+namespace {
+
+    struct BenchObsMesh { std::uint32_t id = 0; };
+
+}
+
+BENCH_CASE(ObserverBench) {
+    for (std::size_t n : bench::kSizes) {
+        const std::size_t touched = n / 100;
+
+        {
+            ECS ecs;
+            ecs.RegisterComponent<BenchObsMesh>();
+            std::vector<Entity> entities = ecs.CreateEntities(n, BenchObsMesh{});
+
+            std::size_t seen = 0;
+            ecs.OnAdd<BenchObsMesh>([&](const Entity*, std::size_t count) { seen += count; });
+            ecs.OnChange<BenchObsMesh>([&](const Entity*, std::size_t count) { seen += count; });
+            ecs.DispatchObservers();
+
+            // Added: recreate 1% of the entities. Stamps use the current tick.
+            const ChangeTick since = ecs.CurrentTick() - 1;
+            for (std::size_t i = 0; i < touched; ++i) {
+                ecs.DestroyEntity(entities[i]);
+                entities[i] = ecs.CreateEntity();
+                ecs.AddComponent(entities[i], BenchObsMesh{});
+            }
+
+            std::size_t polled = 0;
+            std::int64_t ns = bench::MeasureNs([&] {
+                ecs.View<const BenchObsMesh>().Added<BenchObsMesh>(since).Each([&](const BenchObsMesh&) { ++polled; });
+            });
+            bench::Consume(polled);
+            bench::Report("Observer", "poll added (view)", n, touched, ns);
+
+            ns = bench::MeasureNs([&] { ecs.DispatchObservers(); });
+            bench::Consume(seen);
+            bench::Report("Observer", "dispatch added", n, touched, ns);
+
+            // Changed: stamp a contiguous 1% of the pool.
+            const ChangeTick before = ecs.CurrentTick() - 1;
+            for (std::size_t i = touched; i < 2 * touched; ++i) ecs.MarkChanged<BenchObsMesh>(entities[i]);
+            polled = 0;
+            ns = bench::MeasureNs([&] {
+                ecs.View<const BenchObsMesh>().Changed<BenchObsMesh>(before).Each([&](const BenchObsMesh&) { ++polled; });
+            });
+            bench::Consume(polled);
+            bench::Report("Observer", "poll changed (view)", n, touched, ns);
+
+            ns = bench::MeasureNs([&] { ecs.DispatchObservers(); });
+            bench::Consume(seen);
+            bench::Report("Observer", "dispatch changed", n, touched, ns);
+        }
+
+        // Structural cost with and without an add/remove observer watching.
+        for (const bool observed : { false, true }) {
+            ECS ecs;
+            ecs.RegisterComponent<BenchObsMesh>();
+            std::size_t seen = 0;
+            if (observed) {
+                ecs.OnAdd<BenchObsMesh>([&](const Entity*, std::size_t count) { seen += count; });
+                ecs.OnRemove<BenchObsMesh>([&](const Entity*, std::size_t count) { seen += count; });
+            }
+            const std::vector<Entity> entities = ecs.CreateEntities(n);
+            const std::int64_t ns = bench::MeasureNs([&] {
+                for (const Entity e : entities) ecs.AddComponent(e, BenchObsMesh{});
+                for (const Entity e : entities) ecs.RemoveComponent<BenchObsMesh>(e);
+                ecs.DispatchObservers();
+            });
+            bench::Consume(seen);
+            bench::Report("Observer", observed ? "add+remove observed" : "add+remove unobserved", n, n * 2, ns);
+        }
+    }
+}
@@ -0,0 +1,56 @@
+#include "Bench.h"
+#include "ECS.h"
+#include "JobSystem.h"
+
+#include <cmath>
+
+// One heavy system's worth of work: Each() vs ParallelEach() over the same
+// view, plus the deterministic reduction.
+
+namespace {
+
+    struct BenchBody  { float px = 0.0f, py = 0.0f, pz = 0.0f, vx = 1.0f, vy = 0.5f, vz = 0.25f; };
+    struct BenchForce { float fx = 0.0f, fy = -9.8f, fz = 0.0f; };
+
+    void Integrate(BenchBody& b, const BenchForce& f) {
+        constexpr float dt = 1.0f / 60.0f;
+        b.vx += f.fx * dt; b.vy += f.fy * dt; b.vz += f.fz * dt;
+        const float drag = 1.0f / std::sqrt(1.0f + b.vx * b.vx + b.vy * b.vy + b.vz * b.vz);
+        b.vx *= drag; b.vy *= drag; b.vz *= drag;
+        b.px += b.vx * dt; b.py += b.vy * dt; b.pz += b.vz * dt;
+    }
+
+}
+
+BENCH_CASE(ParallelEachBench) {
+    for (std::size_t n : bench::kSizes) {
+        ECS ecs;
+        ecs.RegisterComponent<BenchBody>();
+        ecs.RegisterComponent<BenchForce>();
+        for (std::size_t i = 0; i < n; ++i) {
+            const Entity e = ecs.CreateEntity();
+            ecs.AddComponent(e, BenchBody{});
+            ecs.AddComponent(e, BenchForce{});
+        }
+        auto view = ecs.View<BenchBody, const BenchForce>();
+
+        std::int64_t ns = bench::MeasureNs([&] {
+            view.Each([](BenchBody& b, const BenchForce& f) { Integrate(b, f); });
+        });
+        bench::Report("View", "each integrate", n, n, ns);
+
+        ns = bench::MeasureNs([&] {
+            view.ParallelEach([](BenchBody& b, const BenchForce& f) { Integrate(b, f); });
+        });
+        bench::Report("View", "parallel integrate", n, n, ns);
+
+        double sum = 0.0;
+        ns = bench::MeasureNs([&] {
+            sum = view.ParallelReduce(0.0,
+                [](double& acc, const BenchBody& b, const BenchForce&) { acc += b.py; },
+                [](double& acc, double partial) { acc += partial; });
+        });
+        bench::Consume(static_cast<std::uint64_t>(std::fabs(sum)));
+        bench::Report("View", "parallel reduce", n, n, ns);
+    }
+}
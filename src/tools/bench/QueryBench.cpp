@@ -0,0 +1,78 @@
+#include "Bench.h"
+#include "ECS.h"
+
+#include <vector>
+
+// Repeated ad-hoc lookups of "has Pos and Vel, not Frozen": a signature scan
+// every time vs a cached Query that is refreshed with nothing changed, after
+// unrelated changes, after a few relevant changes, and after enough to wrap
+// the change log.
+
+namespace {
+
+    struct BenchQueryPos { float x = 0.0f; };
+    struct BenchQueryVel { float x = 1.0f; };
+    struct BenchQueryFrozen { int since = 0; };
+    struct BenchQueryOther { int v = 0; };
+
+    std::size_t ScanSignatures(const EntityManager& em, const Query& query) {
+        std::size_t hits = 0;
+        const auto& slots = em.Slots();
+        const auto& signatures = em.Signatures();
+        for (std::uint32_t slot = 0; slot < slots.size(); ++slot) {
+            if (EntityIndex(slots[slot]) == slot && query.Matches(signatures[slot])) ++hits;
+        }
+        return hits;
+    }
+
+}
+
+BENCH_CASE(QueryBench) {
+    for (std::size_t n : bench::kSizes) {
+        ECS ecs;
+        ecs.RegisterComponent<BenchQueryPos>();
+        ecs.RegisterComponent<BenchQueryVel>();
+        ecs.RegisterComponent<BenchQueryFrozen>();
+        ecs.RegisterComponent<BenchQueryOther>();
+        const std::vector<Entity> entities = ecs.CreateEntities(n, BenchQueryPos{}, BenchQueryVel{});
+        for (std::size_t i = 0; i < n; i += 8) ecs.AddComponent(entities[i], BenchQueryFrozen{});
+
+        Query query = ecs.CreateQuery(ecs.ComponentMask<BenchQueryPos, BenchQueryVel>(), ecs.ComponentMask<BenchQueryFrozen>());
+        const EntityManager& em = ecs.GetEntityManager();
+
+        std::size_t hits = 0;
+        std::int64_t ns = bench::MeasureNs([&] { hits = ScanSignatures(em, query); });
+        bench::Consume(hits);
+        bench::Report("Query", "signature scan", n, n, ns);
+
+        ns = bench::MeasureNs([&] { hits = query.Update(em).Size(); });
+        bench::Consume(hits);
+        bench::Report("Query", "first update", n, n, ns);
+
+        ns = bench::MeasureNs([&] { hits = query.Update(em).Size(); });
+        bench::Consume(hits);
+        bench::Report("Query", "update unchanged", n, 1, ns);
+
+        for (std::size_t i = 0; i < 64; ++i) ecs.AddComponent(entities[i * (n / 64)], BenchQueryOther{});
+        ns = bench::MeasureNs([&] { hits = query.Update(em).Size(); });
+        bench::Consume(hits);
+        bench::Report("Query", "update unrelated", n, 1, ns);
+
+        for (std::size_t i = 1; i < 64 * 8; i += 8) ecs.AddComponent(entities[i], BenchQueryFrozen{});
+        ns = bench::MeasureNs([&] { hits = query.Update(em).Size(); });
+        bench::Consume(hits);
+        bench::Report("Query", "update 64 changes", n, 64, ns);
+
+        // Toggle Frozen on every 8th entity until the change log has wrapped,
+        // which takes more than one pass at the smaller sizes.
+        const auto* frozen = ecs.GetComponentManager().GetComponentArray<BenchQueryFrozen>();
+        const std::uint64_t lastUpdate = em.StructuralEpoch();
+        for (std::size_t i = 2; em.StructuralEpoch() - lastUpdate <= EntityManager::CHANGE_LOG_SIZE; i = (i + 8) % n) {
+            if (frozen->Has(entities[i])) ecs.RemoveComponent<BenchQueryFrozen>(entities[i]);
+            else ecs.AddComponent(entities[i], BenchQueryFrozen{});
+        }
+        ns = bench::MeasureNs([&] { hits = query.Update(em).Size(); });
+        bench::Consume(hits);
+        bench::Report("Query", "update log wrapped", n, n, ns);
+    }
+}
@@ -0,0 +1,71 @@
+#include "Bench.h"
+#include "ECS.h"
+
+#include <algorithm>
+#include <cmath>
+
+// A slow-changing, expensive per-entity system (LOD-selection-like) under
+// each schedule mode, at 60 simulated frames per second. The mean frame
+// shows the amortized cost; the worst frame shows how flat it is.
+
+namespace {
+
+    struct BenchLodBounds { float radius = 1.0f, distance = 10.0f; };
+    struct BenchLodLevel { int level = 0; };
+
+    int SelectLevel(const BenchLodBounds& bounds) {
+        float x = bounds.distance / bounds.radius;
+        for (int k = 0; k < 8; ++k) x = std::sqrt(x * x + 1.0f) - 0.5f;
+        return static_cast<int>(x) & 3;
+    }
+
+    class BenchLodSystem : public ISystem {
+    public:
+        explicit BenchLodSystem(ECS& ecs) : mEcs(ecs) {}
+
+        void Update(float) override {
+            mEcs.View<const BenchLodBounds, BenchLodLevel>().Each([](const BenchLodBounds& b, BenchLodLevel& l) {
+                l.level = SelectLevel(b);
+            });
+        }
+
+        void UpdateSlice(float, const Entity* entities, std::size_t count) override {
+            for (std::size_t i = 0; i < count; ++i) {
+                mEcs.GetComponent<BenchLodLevel>(entities[i]).level = SelectLevel(mEcs.GetComponent<BenchLodBounds>(entities[i]));
+            }
+        }
+
+    private:
+        ECS& mEcs;
+    };
+
+    void RunFrames(const SystemSchedule& schedule, const char* op, std::size_t n) {
+        constexpr int kFrames = 60;
+        ECS ecs;
+        ecs.RegisterComponent<BenchLodBounds>();
+        ecs.RegisterComponent<BenchLodLevel>();
+        ecs.RegisterSystem<BenchLodSystem>(ecs);
+        ecs.SetSystemSignature<BenchLodSystem>(ecs.ComponentMask<BenchLodBounds, BenchLodLevel>());
+        ecs.SetSystemSchedule<BenchLodSystem>(schedule);
+        ecs.CreateEntities(n, BenchLodBounds{}, BenchLodLevel{});
+
+        std::int64_t total = 0, worst = 0;
+        for (int f = 0; f < kFrames; ++f) {
+            const std::int64_t ns = bench::MeasureNs([&] { ecs.Update(1.0f / 60.0f); });
+            total += ns;
+            worst = std::max(worst, ns);
+        }
+        bench::Report("ScheduleMode mean", op, n, kFrames, total);
+        bench::Report("ScheduleMode worst", op, n, 1, worst);
+    }
+
+}
+
+BENCH_CASE(ScheduleModeBench) {
+    for (std::size_t n : bench::kSizes) {
+        RunFrames(SystemSchedule::EveryFrame(), "every frame", n);
+        RunFrames(SystemSchedule::EveryNFrames(6), "every 6 frames", n);
+        RunFrames(SystemSchedule::FixedHz(10.0), "fixed 10 Hz", n);
+        RunFrames(SystemSchedule::TimeSliced(100), "sliced 100 us", n);
+    }
+}
@@ -0,0 +1,116 @@
+#include "Bench.h"
+#include "ECS.h"
+#include "JobSystem.h"
+#include "Trace.h"
+#include "TraceChrome.h"
+
+#include <cmath>
+#include <cstdio>
+
+// Eight synthetic systems, each reading its own input and writing its own
+// output, plus one system that reads every output. The first eight land in
+// one wave; the reducer gets a wave of its own.
+
+namespace {
+
+    constexpr int kLanes = 8;
+
+    template<int I> struct BenchIn  { float v = float(I + 1); };
+    template<int I> struct BenchOut { float v = 0.0f; };
+
+    template<int I>
+    class LaneSystem : public ISystem {
+    public:
+        explicit LaneSystem(ECS& ecs) : mEcs(ecs) {}
+
+        void Update(float dt) override {
+            mEcs.View<const BenchIn<I>, BenchOut<I>>().Each([dt](const BenchIn<I>& in, BenchOut<I>& out) {
+                // Enough arithmetic per entity that the lane is compute bound.
+                float x = in.v + out.v * dt;
+                for (int k = 0; k < 16; ++k) x = std::sqrt(x * x + 1.0f) - 0.5f;
+                out.v = x;
+            });
+        }
+
+    private:
+        ECS& mEcs;
+    };
+
+    class ReduceSystem : public ISystem {
+    public:
+        explicit ReduceSystem(ECS& ecs) : mEcs(ecs) {}
+
+        void Update(float) override {
+            float sum = 0.0f;
+            mEcs.View<const BenchOut<0>>().Each([&](const BenchOut<0>& out) { sum += out.v; });
+            bench::Consume(static_cast<std::uint64_t>(sum));
+        }
+
+    private:
+        ECS& mEcs;
+    };
+
+    template<int... Is>
+    void SetupLanes(ECS& ecs, std::size_t n, std::integer_sequence<int, Is...>) {
+        (ecs.RegisterComponent<BenchIn<Is>>(), ...);
+        (ecs.RegisterComponent<BenchOut<Is>>(), ...);
+
+        for (std::size_t i = 0; i < n; ++i) {
+            const Entity e = ecs.CreateEntity();
+            (ecs.AddComponent(e, BenchIn<Is>{}), ...);
+            (ecs.AddComponent(e, BenchOut<Is>{}), ...);
+        }
+
+        auto registerLane = [&](auto lane) {
+            constexpr int I = decltype(lane)::value;
+            ecs.RegisterSystem<LaneSystem<I>>(ecs);
+            SystemAccess access;
+            access.reads = ecs.ComponentMask<BenchIn<I>>();
+            access.writes = ecs.ComponentMask<BenchOut<I>>();
+            ecs.SetSystemAccess<LaneSystem<I>>(access);
+        };
+        (registerLane(std::integral_constant<int, Is>{}), ...);
+
+        ecs.RegisterSystem<ReduceSystem>(ecs);
+        SystemAccess access;
+        access.reads = ecs.ComponentMask<BenchOut<Is>...>();
+        ecs.SetSystemAccess<ReduceSystem>(access);
+    }
+
+    void RunFrames(ECS& ecs, const char* op, std::size_t n) {
+        constexpr int kFrames = 10;
+        ecs.Update(1.0f / 60.0f); // warm-up
+        const std::int64_t ns = bench::MeasureNs([&] {
+            for (int f = 0; f < kFrames; ++f) ecs.Update(1.0f / 60.0f);
+        });
+        bench::Report("Scheduler", op, n, std::size_t(kFrames) * n, ns);
+    }
+
+}
+
+BENCH_CASE(SchedulerBench) {
+    diag::TraceCollector traces;
+    for (std::size_t n : bench::kSizes) {
+        ECS ecs;
+        SetupLanes(ecs, n, std::make_integer_sequence<int, kLanes>{});
+        bench::ReportCount("Scheduler", "workers", n, jobs::WorkerCount());
+        bench::ReportCount("Scheduler", "waves", n, ecs.GetSystemManager().WaveCount());
+
+        ecs.GetSystemManager().SetParallelUpdate(false);
+        RunFrames(ecs, "serial frame", n);
+
+        ecs.GetSystemManager().SetParallelUpdate(true);
+        RunFrames(ecs, "parallel frame", n);
+
+        // Keep one parallel frame of the largest run for chrome://tracing.
+        if (!bench::TracesEnabled()) continue;
+        traces.endFrame(0);
+        traces.clear();
+        ecs.Update(1.0f / 60.0f);
+        traces.endFrame(0);
+    }
+
+    if (bench::TracesEnabled() && diag::WriteChromeTraceJSON(traces, "scheduler_trace.json")) {
+        std::printf("wrote scheduler_trace.json\n");
+    }
+}
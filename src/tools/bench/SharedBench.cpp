@@ -0,0 +1,95 @@
+#include "Bench.h"
+#include "ECS.h"
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+// A MeshRenderer-shaped component (three shared_ptrs) on every entity, with
+// only a few distinct combinations: stored per entity in a dense pool vs
+// once per value in a shared pool, plus walking it grouped by value.
+
+namespace {
+
+    struct BenchRenderRef {
+        std::shared_ptr<int> mesh;
+        std::shared_ptr<int> shader;
+        std::shared_ptr<int> texture;
+
+        bool operator==(const BenchRenderRef&) const = default;
+    };
+
+    // Same value, registered as shared.
+    struct BenchSharedRenderRef : BenchRenderRef {};
+
+    constexpr std::size_t kCombinations = 8;
+
+}
+
+template<>
+struct std::hash<BenchRenderRef> {
+    std::size_t operator()(const BenchRenderRef& r) const noexcept {
+        std::size_t h = std::hash<const void*>{}(r.mesh.get());
+        h = h * 31 + std::hash<const void*>{}(r.shader.get());
+        return h * 31 + std::hash<const void*>{}(r.texture.get());
+    }
+};
+
+template<>
+struct std::hash<BenchSharedRenderRef> : std::hash<BenchRenderRef> {};
+
+template<>
+inline constexpr bool IsSharedComponent<BenchSharedRenderRef> = true;
+
+BENCH_CASE(SharedBench) {
+    std::vector<BenchRenderRef> combos;
+    std::vector<BenchSharedRenderRef> sharedCombos;
+    for (std::size_t i = 0; i < kCombinations; ++i) {
+        combos.push_back(BenchRenderRef{ std::make_shared<int>(int(i)), std::make_shared<int>(int(i % 2)), nullptr });
+        sharedCombos.push_back(BenchSharedRenderRef{ combos.back() });
+    }
+
+    for (std::size_t n : bench::kSizes) {
+        {
+            ECS ecs;
+            ecs.RegisterComponent<BenchRenderRef>();
+            const std::vector<Entity> entities = ecs.CreateEntities(n);
+            std::int64_t ns = bench::MeasureNs([&] {
+                for (std::size_t i = 0; i < n; ++i) ecs.AddComponent(entities[i], combos[i % kCombinations]);
+            });
+            bench::Report("Shared dense", "assign", n, n, ns);
+            bench::ReportBytes("Shared dense", "pool bytes", n,
+                ecs.GetComponentManager().GetComponentArray<BenchRenderRef>()->BytesReserved());
+
+            std::size_t sum = 0;
+            ns = bench::MeasureNs([&] {
+                ecs.View<const BenchRenderRef>().Each([&](const BenchRenderRef& r) { sum += std::size_t(*r.mesh); });
+            });
+            bench::Consume(sum);
+            bench::Report("Shared dense", "view", n, n, ns);
+        }
+        {
+            ECS ecs;
+            ecs.RegisterSharedComponent<BenchSharedRenderRef>();
+            const std::vector<Entity> entities = ecs.CreateEntities(n);
+            std::int64_t ns = bench::MeasureNs([&] {
+                for (std::size_t i = 0; i < n; ++i) ecs.SetSharedComponent(entities[i], sharedCombos[i % kCombinations]);
+            });
+            bench::Report("Shared flyweight", "assign", n, n, ns);
+            bench::ReportBytes("Shared flyweight", "pool bytes", n,
+                ecs.GetComponentManager().GetSharedArray<BenchSharedRenderRef>()->BytesReserved());
+
+            // First call pays for the grouping sort, the second reuses it.
+            for (const char* op : { "group (rebuild)", "group (cached)" }) {
+                std::size_t sum = 0;
+                ns = bench::MeasureNs([&] {
+                    ecs.EachGroup<BenchSharedRenderRef>([&](const BenchSharedRenderRef& r, const Entity* group, std::size_t count) {
+                        sum += std::size_t(*r.mesh) * count + (count ? group[0] : 0);
+                    });
+                });
+                bench::Consume(sum);
+                bench::Report("Shared flyweight", op, n, n, ns);
+            }
+        }
+    }
+}
@@ -0,0 +1,53 @@
+#include "Bench.h"
+#include "ECS.h"
+#include "Snapshot.h"
+
+#include <vector>
+
+// Publishing a 64-byte transform-sized component: the first (full copy)
+// snapshot, then one with nothing changed, a contiguous 1% changed, 1%
+// spread one per 100 entities (which dirties every chunk), and every
+// entity changed.
+
+namespace {
+
+    struct BenchSnapTransform { float m[16] = {}; };
+
+}
+
+BENCH_CASE(SnapshotBench) {
+    for (std::size_t n : bench::kSizes) {
+        ECS ecs;
+        ecs.RegisterComponent<BenchSnapTransform>();
+        const std::vector<Entity> entities = ecs.CreateEntities(n, BenchSnapTransform{});
+
+        SnapshotPublisher publisher(ecs);
+        publisher.Track<BenchSnapTransform>();
+
+        std::int64_t ns = bench::MeasureNs([&] { publisher.Publish(); });
+        bench::Report("Snapshot", "first publish", n, n, ns);
+
+        ns = bench::MeasureNs([&] { publisher.Publish(); });
+        bench::Report("Snapshot", "publish unchanged", n, n, ns);
+
+        for (std::size_t i = 0; i < n / 100; ++i) ecs.MarkChanged<BenchSnapTransform>(entities[i]);
+        ns = bench::MeasureNs([&] { publisher.Publish(); });
+        bench::Report("Snapshot", "publish 1% clustered", n, n, ns);
+
+        for (std::size_t i = 0; i < n; i += 100) ecs.MarkChanged<BenchSnapTransform>(entities[i]);
+        ns = bench::MeasureNs([&] { publisher.Publish(); });
+        bench::Report("Snapshot", "publish 1% spread", n, n, ns);
+
+        ecs.View<BenchSnapTransform>().Each([](BenchSnapTransform& t) { t.m[0] += 1.0f; });
+        ns = bench::MeasureNs([&] { publisher.Publish(); });
+        bench::Report("Snapshot", "publish all changed", n, n, ns);
+
+        float sum = 0.0f;
+        const auto snapshot = publisher.Latest();
+        ns = bench::MeasureNs([&] {
+            snapshot->Pool<BenchSnapTransform>()->Each([&](Entity, const BenchSnapTransform& t) { sum += t.m[0]; });
+        });
+        bench::Consume(static_cast<std::uint64_t>(sum));
+        bench::Report("Snapshot", "read", n, n, ns);
+    }
+}
@@ -0,0 +1,64 @@
+#include "Bench.h"
+#include "ECS.h"
+
+#include <vector>
+
+// Spawning n entities one call at a time vs. a single CreateEntities batch,
+// with one system registered so membership updates are part of the cost.
+
+namespace {
+
+    struct BenchSpawnPos { float x = 0.0f, y = 0.0f, z = 0.0f; };
+    struct BenchSpawnVel { float x = 1.0f, y = 0.0f, z = 0.0f; };
+
+    class BenchMover : public ISystem {
+    public:
+        void Update(float) override {}
+    };
+
+    void Setup(ECS& ecs) {
+        ecs.RegisterComponent<BenchSpawnPos>();
+        ecs.RegisterComponent<BenchSpawnVel>();
+        ecs.RegisterSystem<BenchMover>();
+        ecs.SetSystemSignature<BenchMover>(ecs.ComponentMask<BenchSpawnPos, BenchSpawnVel>());
+    }
+
+}
+
+BENCH_CASE(SpawnBench) {
+    for (std::size_t n : bench::kSizes) {
+        {
+            ECS ecs;
+            Setup(ecs);
+            std::vector<Entity> entities(n);
+            const std::int64_t ns = bench::MeasureNs([&] {
+                for (std::size_t i = 0; i < n; ++i) {
+                    const Entity e = ecs.CreateEntity();
+                    ecs.AddComponent(e, BenchSpawnPos{});
+                    ecs.AddComponent(e, BenchSpawnVel{});
+                    entities[i] = e;
+                }
+            });
+            bench::Report("Spawn", "one by one", n, n, ns);
+        }
+        {
+            ECS ecs;
+            Setup(ecs);
+            std::vector<Entity> entities;
+            std::int64_t ns = bench::MeasureNs([&] {
+                entities = ecs.CreateEntities(n, BenchSpawnPos{}, BenchSpawnVel{});
+            });
+            bench::Report("Spawn", "CreateEntities", n, n, ns);
+
+            ns = bench::MeasureNs([&] {
+                ecs.DestroyEntities(entities.data(), entities.size());
+            });
+            bench::Report("Spawn", "DestroyEntities", n, n, ns);
+
+            ns = bench::MeasureNs([&] {
+                entities = ecs.CreateEntities(n, BenchSpawnPos{}, BenchSpawnVel{});
+            });
+            bench::Report("Spawn", "CreateEntities reuse", n, n, ns);
+        }
+    }
+}
@@ -0,0 +1,71 @@
+#include "Bench.h"
+#include "ECS.h"
+
+#include <vector>
+
+// Resident bytes and iteration cost per storage policy: a handful of rare
+// components spread over the slot range, and a marker on every tenth
+// entity stored as a dense empty component vs a tag.
+
+namespace {
+
+    struct BenchStorePos { float x = 0.0f, y = 0.0f, z = 0.0f; };
+    struct BenchStoreRare { float fov = 1.0f, nearPlane = 0.1f, farPlane = 100.0f; };
+    struct BenchStoreMarker {};
+
+    constexpr std::size_t kRareCount = 4;
+
+    const char* PolicyName(StoragePolicy policy) {
+        switch (policy) {
+        case StoragePolicy::Dense: return "dense";
+        case StoragePolicy::SparsePaged: return "sparse paged";
+        case StoragePolicy::Tag: return "tag";
+        }
+        return "?";
+    }
+
+}
+
+BENCH_CASE(StorageBench) {
+    for (std::size_t n : bench::kSizes) {
+        for (const StoragePolicy sparse : { StoragePolicy::Dense, StoragePolicy::SparsePaged }) {
+            ECS ecs;
+            ecs.RegisterComponent<BenchStorePos>();
+            ecs.RegisterComponent<BenchStoreRare>(sparse);
+            const std::vector<Entity> entities = ecs.CreateEntities(n, BenchStorePos{});
+            for (std::size_t i = 0; i < kRareCount; ++i) {
+                ecs.AddComponent(entities[(i + 1) * (n - 1) / kRareCount], BenchStoreRare{});
+            }
+
+            auto* rare = ecs.GetComponentManager().GetComponentArray<BenchStoreRare>();
+            bench::ReportBytes("Storage rare", PolicyName(sparse), n, rare->BytesReserved());
+
+            float sum = 0.0f;
+            const std::int64_t ns = bench::MeasureNs([&] {
+                ecs.View<const BenchStorePos, const BenchStoreRare>().Each(
+                    [&](const BenchStorePos& p, const BenchStoreRare& r) { sum += p.x + r.fov; });
+            });
+            bench::Consume(static_cast<std::uint64_t>(sum));
+            bench::Report("Storage rare", PolicyName(sparse), n, kRareCount, ns);
+        }
+
+        for (const StoragePolicy marker : { StoragePolicy::Dense, StoragePolicy::Tag }) {
+            ECS ecs;
+            ecs.RegisterComponent<BenchStorePos>();
+            ecs.RegisterComponent<BenchStoreMarker>(marker);
+            const std::vector<Entity> entities = ecs.CreateEntities(n, BenchStorePos{});
+            for (std::size_t i = 0; i < n; i += 10) ecs.AddComponent(entities[i], BenchStoreMarker{});
+
+            auto* markers = ecs.GetComponentManager().GetComponentArray<BenchStoreMarker>();
+            bench::ReportBytes("Storage marker", PolicyName(marker), n, markers->BytesReserved());
+
+            std::size_t hits = 0;
+            const std::int64_t ns = bench::MeasureNs([&] {
+                ecs.View<const BenchStorePos, const BenchStoreMarker>().Each(
+                    [&](const BenchStorePos&, const BenchStoreMarker&) { ++hits; });
+            });
+            bench::Consume(hits);
+            bench::Report("Storage marker", PolicyName(marker), n, hits, ns);
+        }
+    }
+}
@@ -0,0 +1,105 @@
+#include "Bench.h"
+#include "TransformKernel.h"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+// TRS -> matrix composition: the per-transform glm expression used before
+// the kernel vs xform::ComposeEuler/ComposeQuat at each ISA. Every kernel
+// run is also compared element for element against the glm result, since
+// the kernel promises bit-identical output.
+
+namespace {
+
+    constexpr std::size_t kTransforms = 100'000;
+
+    struct Inputs {
+        std::vector<float> fields[13];
+        xform::TrsSoA soa;
+    };
+
+    void Fill(Inputs& in, std::size_t n) {
+        std::mt19937 rng(1234);
+        std::uniform_real_distribution<float> pos(-100.0f, 100.0f);
+        std::uniform_real_distribution<float> ang(-3.14159f, 3.14159f);
+        std::uniform_real_distribution<float> scl(0.1f, 4.0f);
+        std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+        for (int f = 0; f < 13; ++f) {
+            in.fields[f].resize(n);
+            for (float& v : in.fields[f]) {
+                v = f < 3 ? pos(rng) : f < 6 ? ang(rng) : f < 10 ? unit(rng) : scl(rng);
+            }
+        }
+        in.soa.px = in.fields[0].data();  in.soa.py = in.fields[1].data();  in.soa.pz = in.fields[2].data();
+        in.soa.rx = in.fields[3].data();  in.soa.ry = in.fields[4].data();  in.soa.rz = in.fields[5].data();
+        in.soa.qx = in.fields[6].data();  in.soa.qy = in.fields[7].data();  in.soa.qz = in.fields[8].data();
+        in.soa.qw = in.fields[9].data();
+        in.soa.sx = in.fields[10].data(); in.soa.sy = in.fields[11].data(); in.soa.sz = in.fields[12].data();
+    }
+
+    void ComposeGlm(const xform::TrsSoA& in, std::size_t n, bool euler, glm::mat4* out) {
+        for (std::size_t i = 0; i < n; ++i) {
+            const glm::quat q = euler
+                ? glm::quat(glm::vec3(in.rx[i], in.ry[i], in.rz[i]))
+                : glm::quat(in.qw[i], in.qx[i], in.qy[i], in.qz[i]);
+            glm::mat4 m = glm::translate(glm::mat4(1.0f), glm::vec3(in.px[i], in.py[i], in.pz[i]));
+            m *= glm::mat4_cast(q);
+            out[i] = glm::scale(m, glm::vec3(in.sx[i], in.sy[i], in.sz[i]));
+        }
+    }
+
+    // Elements that differ from glm; -0 and +0 compare equal.
+    std::size_t Mismatches(const std::vector<glm::mat4>& expected, const std::vector<float>& actual) {
+        std::size_t bad = 0;
+        for (std::size_t i = 0; i < expected.size(); ++i) {
+            float ref[16];
+            std::memcpy(ref, &expected[i], sizeof(ref));
+            for (int k = 0; k < 16; ++k) {
+                if (ref[k] != actual[16 * i + k]) ++bad;
+            }
+        }
+        return bad;
+    }
+
+}
+
+BENCH_CASE(TransformKernelBench) {
+    static_assert(sizeof(glm::mat4) == 16 * sizeof(float));
+
+    Inputs in;
+    Fill(in, kTransforms);
+
+    std::vector<glm::mat4> reference(kTransforms);
+    std::vector<float>     out(16 * kTransforms);
+    const xform::Isa best = xform::DetectIsa();
+
+    for (const bool euler : { true, false }) {
+        const char* group = euler ? "TRS euler" : "TRS quat";
+
+        std::int64_t ns = bench::MeasureNs([&] { ComposeGlm(in.soa, kTransforms, euler, reference.data()); });
+        bench::Report(group, "glm", kTransforms, kTransforms, ns);
+
+        for (const xform::Isa isa : { xform::Isa::Scalar, xform::Isa::SSE, xform::Isa::AVX2 }) {
+            if (isa > best) continue;
+            xform::SetIsa(isa);
+
+            ns = bench::MeasureNs([&] {
+                if (euler) xform::ComposeEuler(in.soa, kTransforms, out.data());
+                else       xform::ComposeQuat(in.soa, kTransforms, out.data());
+            });
+            bench::Report(group, xform::IsaName(isa), kTransforms, kTransforms, ns);
+
+            const std::size_t bad = Mismatches(reference, out);
+            if (bad) std::printf("  %s: %zu elements differ from glm\n", xform::IsaName(isa), bad);
+        }
+        bench::Consume(static_cast<std::uint64_t>(out[16 * (kTransforms - 1) + 12]));
+    }
+    xform::SetIsa(best);
+}
@@ -26,6 +26,9 @@ namespace diag {
         bool saveChromeTrace(const char* path);
         void addCpuScope(const char* name, double ms) { metrics_.addCpuScope(name, ms); }
         void addGpuScope(const char* name, double ms) { metrics_.addGpuScope(name, ms); }
+        void addSystemSample(const char* name, double ms, size_t entities, double budgetMs) {
+            metrics_.addSystemSample(name, ms, entities, budgetMs);
+        }
 
         MetricsRegistry& metrics() { return metrics_; }
         TraceCollector& traces() { return traces_; }
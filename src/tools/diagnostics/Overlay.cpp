@@ -6,6 +6,7 @@
 
 #include <imgui/imgui.h>
 
+#include <algorithm>
 #include <cstdint>
 #include <cstdio>
 #include <string>
@@ -17,7 +18,8 @@ namespace diag {
         std::uint64_t bTex,
         std::uint64_t bBuf,
         std::uint64_t bMesh,
-        std::uint64_t bOther)
+        std::uint64_t bOther,
+        std::uint64_t bEcs)
     {
         auto line = [&](const char* name, std::uint64_t bytes) {
             double mb = double(bytes) / (1024.0 * 1024.0);
@@ -36,9 +38,56 @@ namespace diag {
         line("Buf", bBuf);
         line("Mesh", bMesh);
         line("Other", bOther);
+        line("ECS", bEcs);
         ImGui::Unindent();
     }
 
+    static void BytesCell(std::uint64_t bytes)
+    {
+        const double kb = double(bytes) / 1024.0;
+        if (kb >= 1024.0) ImGui::Text("%.2f MB", kb / 1024.0);
+        else ImGui::Text("%.1f KB", kb);
+    }
+
+    static void EcsMemoryTable(const EngineMemory& memE)
+    {
+        if (!ImGui::CollapsingHeader("ECS Memory")) return;
+
+        ImGui::Text("Entity table: %.1f KB  System sets: %.1f KB",
+            double(memE.ecs_entities) / 1024.0, double(memE.ecs_systems) / 1024.0);
+
+        if (ImGui::BeginTable("EcsPools", 6,
+            ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders))
+        {
+            ImGui::TableSetupColumn("Pool");
+            ImGui::TableSetupColumn("live");
+            ImGui::TableSetupColumn("capacity");
+            ImGui::TableSetupColumn("reserved");
+            ImGui::TableSetupColumn("used");
+            ImGui::TableSetupColumn("waste");
+            ImGui::TableHeadersRow();
+
+            for (auto& p : memE.ecs_pools) {
+                ImGui::TableNextRow();
+                ImGui::TableSetColumnIndex(0);
+                ImGui::TextUnformatted(p.name ? p.name : "(pool)");
+                ImGui::TableSetColumnIndex(1);
+                ImGui::Text("%llu", static_cast<unsigned long long>(p.live));
+                ImGui::TableSetColumnIndex(2);
+                ImGui::Text("%llu", static_cast<unsigned long long>(p.capacity));
+                ImGui::TableSetColumnIndex(3);
+                BytesCell(p.reserved);
+                ImGui::TableSetColumnIndex(4);
+                BytesCell(p.used);
+                ImGui::TableSetColumnIndex(5);
+                const double waste = p.reserved ? 100.0 * double(p.reserved - std::min(p.used, p.reserved)) / double(p.reserved) : 0.0;
+                if (waste >= 50.0) ImGui::TextColored(ImVec4(1.f, 0.8f, 0.2f, 1.f), "%.0f%%", waste);
+                else ImGui::Text("%.0f%%", waste);
+            }
+            ImGui::EndTable();
+        }
+    }
+
     static const char* SwapIntervalLabel(int interval)
     {
         switch (interval) {
@@ -131,7 +180,8 @@ namespace diag {
                 double(memP.peak_bytes) / (1024.0 * 1024.0));
 
             PrintBytesPretty("Engine Memory",
-                memE.textures, memE.buffers, memE.meshes, memE.other);
+                memE.textures, memE.buffers, memE.meshes, memE.other, memE.ecsReserved());
+            EcsMemoryTable(memE);
 
             // Frametime plot (last N frames)
             auto snap_d = mr.frameTimesMs().snapshot();
@@ -184,6 +234,55 @@ namespace diag {
                 ImGui::EndTable();
             }
 
+            // ECS system table: this frame, rolling percentiles, budget
+            const auto& systems = mr.lastSystems();
+            int overBudget = 0;
+            for (auto& s : systems) {
+                if (s.over_budget) ++overBudget;
+            }
+            ImGui::Text("Systems: %zu", systems.size());
+            if (overBudget > 0) {
+                ImGui::SameLine();
+                ImGui::TextColored(ImVec4(1.f, 0.4f, 0.4f, 1.f), "| %d over budget", overBudget);
+            }
+
+            if (!systems.empty() && ImGui::BeginTable("Systems", 7,
+                ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders))
+            {
+                ImGui::TableSetupColumn("System");
+                ImGui::TableSetupColumn("ms");
+                ImGui::TableSetupColumn("p50");
+                ImGui::TableSetupColumn("p95");
+                ImGui::TableSetupColumn("p99");
+                ImGui::TableSetupColumn("entities");
+                ImGui::TableSetupColumn("budget");
+                ImGui::TableHeadersRow();
+
+                const ImVec4 overColor(1.f, 0.4f, 0.4f, 1.f);
+                for (auto& s : systems) {
+                    const SystemStats stats = mr.systemStats(s);
+                    ImGui::TableNextRow();
+                    ImGui::TableSetColumnIndex(0);
+                    if (s.over_budget) ImGui::TextColored(overColor, "%s", s.name ? s.name : "(system)");
+                    else ImGui::TextUnformatted(s.name ? s.name : "(system)");
+                    ImGui::TableSetColumnIndex(1);
+                    if (s.over_budget) ImGui::TextColored(overColor, "%.3f", s.ms);
+                    else ImGui::Text("%.3f", s.ms);
+                    ImGui::TableSetColumnIndex(2);
+                    ImGui::Text("%.3f", stats.pct.p50);
+                    ImGui::TableSetColumnIndex(3);
+                    ImGui::Text("%.3f", stats.pct.p95);
+                    ImGui::TableSetColumnIndex(4);
+                    ImGui::Text("%.3f", stats.pct.p99);
+                    ImGui::TableSetColumnIndex(5);
+                    ImGui::Text("%zu", s.entities);
+                    ImGui::TableSetColumnIndex(6);
+                    if (s.budget_ms > 0.0) ImGui::Text("%.2f (%d over)", s.budget_ms, stats.overruns);
+                    else ImGui::TextUnformatted("-");
+                }
+                ImGui::EndTable();
+            }
+
             // GPU scope table
             if (ImGui::BeginTable("GPUScopes", 3,
                 ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders))